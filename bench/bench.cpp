@@ -0,0 +1,229 @@
+// Parse-performance benchmark of greet.
+//
+// Build and run it from the root of the repository:
+//
+//     g++ bench/bench.cpp -std=c++23 -O2 -I. -o bench/bench && bench/bench
+//
+// Schema construction (`genmeta()` and building the flag tables) is measured
+// separately from parsing with a reused `greet::parser`, `greet::greet()` pays
+// for both on every call.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "greet.hpp"
+
+namespace {
+size_t allocations = 0;
+
+// keeps the optimizer from dropping the measured work
+volatile size_t sink = 0;
+
+// Argument groups with `N` generated NORMAL options `--opt0` ... `--opt<N-1>`,
+// besides a few fixed options the argument list shapes rely on.
+template <size_t N>
+struct Schema : public greet::information {
+    std::array<int, N> values{};
+    bool greeted = false;
+    greet::counter times;
+    std::vector<std::string> places;
+    std::vector<std::string> items;
+    greet::ignored others;
+
+    std::string version() override { return "bench"; }
+    std::string description() override { return "generated schema"; }
+    // out of line to keep the compile time of large schemas reasonable
+    auto value_opt(size_t i) {
+        return greet::opt(values[i]).lng("opt" + std::to_string(i));
+    }
+
+    greet::meta genmeta() override {
+        return [this]<size_t... I>(std::index_sequence<I...>) {
+            return greet::meta{
+                value_opt(I)...,
+                greet::opt(greeted).shrt('g'),
+                greet::opt(times).shrt('t'),
+                greet::opt(places).shrt('p').lng("place").allow_hyphen(),
+                greet::opt(items).lng("item").delimiter(','),
+                greet::opt(others),
+            };
+        }(std::make_index_sequence<N>{});
+    }
+};
+
+// An argument list, `argv()` is what `main()` would receive.
+class arglist {
+  public:
+    explicit arglist(std::string name) : _name(std::move(name)) {
+        push("bench");
+    }
+
+    void push(std::string token) { _tokens.push_back(std::move(token)); }
+    const std::string &name() const { return _name; }
+    size_t tokens() const { return _tokens.size() - 1; }
+
+    std::vector<char *> argv() {
+        std::vector<char *> result;
+        for (auto &token : _tokens) result.push_back(token.data());
+        return result;
+    }
+
+  private:
+    std::string _name;
+    std::vector<std::string> _tokens;
+};
+
+std::vector<arglist> shapes(size_t options) {
+    std::vector<arglist> result;
+
+    arglist clusters("short clusters");
+    clusters.push("-g");
+    for (size_t i = 0; i < 1000; ++i) clusters.push("-ttttp=-san-diego");
+    result.push_back(std::move(clusters));
+
+    arglist longs("--long=value");
+    for (size_t i = 0; i < options; ++i)
+        longs.push(std::format("--opt{}={}", i, i));
+    result.push_back(std::move(longs));
+
+    arglist vector("large vector");
+    for (size_t i = 0; i < 1000; ++i) {
+        vector.push("--place");
+        vector.push(std::format("place-{}", i));
+    }
+    result.push_back(std::move(vector));
+
+    arglist delimited("delimited vector");
+    std::string items;
+    for (size_t i = 0; i < 1000; ++i) items += std::format("item-{},", i);
+    items.pop_back();
+    delimited.push("--item=" + items);
+    result.push_back(std::move(delimited));
+
+    arglist tail("-- tail");
+    tail.push("--");
+    for (size_t i = 0; i < 10000; ++i) tail.push(std::format("tail-{}", i));
+    result.push_back(std::move(tail));
+
+    return result;
+}
+
+// Calls `fn` until it has run for a while, returns the nanoseconds and the
+// allocations of one call.
+template <typename FnT>
+std::pair<double, double> measure(FnT &&fn) {
+    using clock = std::chrono::steady_clock;
+    fn();  // warm up
+
+    size_t runs = 0;
+    size_t before = allocations;
+    auto start = clock::now();
+    auto elapsed = clock::duration{};
+    while (elapsed < std::chrono::milliseconds(200)) {
+        fn();
+        ++runs;
+        elapsed = clock::now() - start;
+    }
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    return {ns / runs, double(allocations - before) / runs};
+}
+
+template <size_t N>
+void run() {
+    auto [build_ns, build_allocs] = measure([] {
+        Schema<N> args;
+        auto m = args.genmeta();
+        sink = sink + m.opts().size();
+    });
+    std::printf(
+        "%5zu options  %-18s %14.0f ns %13.1f allocs\n",
+        N,
+        "schema",
+        build_ns,
+        build_allocs);
+
+    greet::parser<Schema<N>> parser;
+    for (auto &shape : shapes(N)) {
+        std::vector<char *> argv = shape.argv();
+        int argc = static_cast<int>(argv.size());
+
+        auto [parse_ns, parse_allocs] = measure([&] {
+            sink = sink + parser.parse(argc, argv.data()).places.size();
+        });
+        auto [greet_ns, greet_allocs] = measure([&] {
+            sink = sink +
+                   greet::greet<Schema<N>>(argc, argv.data()).places.size();
+        });
+        std::printf(
+            "%5zu options  %-18s parser %7.1f ns/token %7.1f allocs  "
+            "greet %7.1f ns/token %7.1f allocs\n",
+            N,
+            shape.name().c_str(),
+            parse_ns / shape.tokens(),
+            parse_allocs,
+            greet_ns / shape.tokens(),
+            greet_allocs);
+    }
+}
+
+// Out of line, so that GCC doesn't see `free()` called on a pointer from an
+// inlined `operator new` and warn about a mismatch.
+[[gnu::noinline]] void release(void *ptr) noexcept { std::free(ptr); }
+}  // namespace
+
+// `std::pmr` resources allocate through the aligned overloads, so they are
+// counted as well, and every delete matches the new it releases
+void *operator new(size_t size) {
+    ++allocations;
+    if (void *ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new(size_t size, std::align_val_t alignment) {
+    ++allocations;
+    size_t align = std::max(static_cast<size_t>(alignment), sizeof(void *));
+    // `aligned_alloc()` needs a multiple of the alignment
+    size = (std::max<size_t>(size, 1) + align - 1) / align * align;
+    if (void *ptr = std::aligned_alloc(align, size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void *operator new[](size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void operator delete(void *ptr) noexcept { release(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { release(ptr); }
+
+void operator delete(void *ptr, std::align_val_t) noexcept { release(ptr); }
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void *ptr) noexcept { release(ptr); }
+
+void operator delete[](void *ptr, size_t) noexcept { release(ptr); }
+
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept {
+    release(ptr);
+}
+
+int main() {
+    run<10>();
+    run<100>();
+    run<1000>();
+    return 0;
+}
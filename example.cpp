@@ -1,3 +1,5 @@
+#include <iostream>
+
 #include "greet.hpp"
 
 struct Args : public greet::information {
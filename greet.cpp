@@ -0,0 +1,12 @@
+// The non-template parts of greet, compiled once for programs that define
+// GREET_SEPARATE_COMPILATION before including `greet.hpp`:
+//
+//     g++ -std=c++23 -c greet.cpp -o greet.o
+//     g++ -std=c++23 -DGREET_SEPARATE_COMPILATION main.cpp greet.o
+
+#ifndef GREET_SEPARATE_COMPILATION
+#define GREET_SEPARATE_COMPILATION
+#endif
+#define GREET_IMPLEMENTATION
+
+#include "greet.hpp"
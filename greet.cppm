@@ -0,0 +1,61 @@
+// The `greet` module, for programs which `import greet;` instead of including
+// `greet.hpp`. The header is compiled once here, in the global module
+// fragment, and only the public interface is exported:
+//
+//     g++ -std=c++23 -fmodules-ts -c greet.cppm -o greet.o
+//     g++ -std=c++23 -fmodules-ts main.cpp greet.o
+//
+// Other compilers name the interface unit differently, e.g. `greet.ixx` for
+// MSVC, and CMake 3.28 or later can drive the build with `FILE_SET CXX_MODULES`.
+
+module;
+
+#include "greet.hpp"
+
+export module greet;
+
+export namespace greet {
+    using greet::abbreviations;
+    using greet::abbreviations_t;
+    using greet::args_group;
+    using greet::arena;
+    using greet::choices;
+    using greet::completion_script;
+    using greet::config_file;
+    using greet::counter;
+    using greet::error;
+    using greet::error_kind;
+    using greet::greet;
+    using greet::ignored;
+    using greet::ignored_view;
+    using greet::information;
+    using greet::inplace_vector;
+    using greet::lazy;
+    using greet::lazy_mode;
+    using greet::load;
+    using greet::load_or_greet;
+    using greet::meta;
+    using greet::null_observer;
+    using greet::opt;
+    using greet::opt_sink;
+    using greet::option;
+    using greet::parse_batch;
+    using greet::parse_observer;
+    using greet::parse_stats;
+    using greet::parse_totals;
+    using greet::parser;
+    using greet::reload_on_sighup;
+    using greet::reloader;
+    using greet::response_files;
+    using greet::save;
+    using greet::static_args_group;
+    using greet::static_information;
+    using greet::static_meta;
+    using greet::string_convertable;
+    using greet::string_converter;
+    using greet::subcommands;
+    using greet::token_kind;
+    using greet::token_range;
+    using greet::tokenize;
+    using greet::try_greet;
+}  // namespace greet
@@ -25,21 +25,62 @@
 #define GREET_HPP
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <charconv>
+#include <chrono>
 #include <concepts>
+#include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <expected>
 #include <format>
-#include <iostream>
+#include <functional>
+#include <iterator>
+#include <mutex>
 #include <memory>
+#include <memory_resource>
 #include <optional>
+#include <source_location>
+#include <span>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <tuple>
-#include <unordered_map>
 #include <utility>
+#include <variant>
 #include <vector>
 
+#ifndef _WIN32
+extern "C" char **environ;
+#endif
+
+// With GREET_SEPARATE_COMPILATION the non-template parts are only declared
+// here and compiled once from `greet.cpp`, which defines GREET_IMPLEMENTATION.
+#ifdef GREET_SEPARATE_COMPILATION
+#define GREET_INLINE
+#else
+#define GREET_INLINE inline
+#endif
+
+#if !defined(GREET_SEPARATE_COMPILATION) || defined(GREET_IMPLEMENTATION)
+#define GREET_DEFINITIONS
+#endif
+
+// only used by the definitions, so separately compiled programs skip them
+#ifdef GREET_DEFINITIONS
+#include <cctype>
+#include <csignal>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#endif
+
 namespace greet {
 namespace _detail {
     template <typename Tp>
@@ -59,20 +100,71 @@ namespace _detail {
         LONG,
     };
 
-    inline size_t argtype(const char *arg) {
-        std::string_view str(arg);
-        if (str == std::string_view("--")) return ENDARG;
-        if (str.starts_with("--")) return LONG;
-        if (str.starts_with("-")) return SHORT;
-        return ARGUMENT;
+    // only the first two bytes decide the kind of a token, a lone `-` is an
+    // argument as it usually stands for the standard input
+    inline size_t argtype(std::string_view str) {
+        if (str.size() < 2 || str[0] != '-') return ARGUMENT;
+        if (str[1] != '-') return SHORT;
+        return str.size() == 2 ? ENDARG : LONG;
+    }
+
+    // Position of the first `c` in `str`, compared eight bytes at a time,
+    // tokens are mostly too short for `memchr()` to pay off.
+    inline size_t find_byte(std::string_view str, char c) {
+        constexpr uint64_t ones = 0x0101010101010101;
+        constexpr uint64_t highs = 0x8080808080808080;
+        const uint64_t pattern = ones * static_cast<unsigned char>(c);
+        size_t pos = 0;
+        for (; pos + 8 <= str.size(); pos += 8) {
+            uint64_t word;
+            std::memcpy(&word, str.data() + pos, 8);
+            if constexpr (std::endian::native == std::endian::big)
+                word = std::byteswap(word);
+            word ^= pattern;
+            // the lowest marked byte is exactly the first equal one
+            if (uint64_t found = (word - ones) & ~word & highs)
+                return pos + std::countr_zero(found) / 8;
+        }
+        for (; pos < str.size(); ++pos)
+            if (str[pos] == c) return pos;
+        return std::string_view::npos;
+    }
+
+    // What the parse loop needs to know about a token, from a single look.
+    struct token_shape {
+        size_t type;
+        // position of the first '=' of a long flag, `npos` if none
+        size_t split;
     };
 
-    inline const char *strend(const char *str) {
-        while (*str != '\0') ++str;
-        return str;
+    inline token_shape classify(std::string_view token) {
+        size_t type = argtype(token);
+        return {
+            .type = type,
+            .split =
+                type == LONG ? find_byte(token, '=') : std::string_view::npos,
+        };
     }
 
-    inline std::string uppercase(std::string str) {
+    // A set of characters, one bit each.
+    class char_set {
+      public:
+        constexpr void set(char c) {
+            auto byte = static_cast<unsigned char>(c);
+            _words[byte / 64] |= uint64_t{1} << (byte % 64);
+        }
+
+        constexpr bool test(char c) const {
+            auto byte = static_cast<unsigned char>(c);
+            return _words[byte / 64] & (uint64_t{1} << (byte % 64));
+        }
+
+      private:
+        std::array<uint64_t, 4> _words{};
+    };
+
+    template <typename StringT>
+    inline StringT uppercase(StringT str) {
         std::transform(str.begin(), str.end(), str.begin(), ::toupper);
         return str;
     }
@@ -81,36 +173,176 @@ namespace _detail {
         return path.substr(path.find_last_of("/\\") + 1);
     }
 
-    inline void remove_one_arg(int &argc, char **(&argv)) {
-        --argc;
-        ++argv;
+    // Options are bound to the members of the argument group which generated
+    // the meta, `offset` moves such a reference to the same member of another
+    // instance of that argument group.
+    template <typename Tp>
+    inline Tp &rebase(Tp &ref, std::ptrdiff_t offset) {
+        return *reinterpret_cast<Tp *>(
+            reinterpret_cast<std::uintptr_t>(&ref) + offset);
+    }
+
+    template <typename Tp>
+    inline std::ptrdiff_t offset_between(const Tp &from, const Tp &to) {
+        return static_cast<std::ptrdiff_t>(
+            reinterpret_cast<std::uintptr_t>(&to) -
+            reinterpret_cast<std::uintptr_t>(&from));
+    }
+
+    // Schema, help and parse-time allocations of the current thread come from
+    // this resource, `greet()` installs a `greet::arena` by default.
+    inline std::pmr::memory_resource *&current_resource() {
+        thread_local std::pmr::memory_resource *resource =
+            std::pmr::new_delete_resource();
+        return resource;
+    }
+
+    // Installs `resource` as the current resource until it goes out of scope.
+    class resource_scope {
+      public:
+        explicit resource_scope(std::pmr::memory_resource *resource) :
+            _previous(std::exchange(current_resource(), resource)) {}
+        resource_scope(const resource_scope &) = delete;
+        ~resource_scope() { current_resource() = _previous; }
+
+      private:
+        std::pmr::memory_resource *_previous;
+    };
+
+    template <typename FnT>
+    decltype(auto) with_resource(
+        std::pmr::memory_resource *resource, FnT &&fn) {
+        resource_scope scope(resource);
+        return std::forward<FnT>(fn)();
+    }
+
+    // A polymorphic allocator which defaults to the current resource, also
+    // when a container is copied.
+    template <typename Tp>
+    class allocator : public std::pmr::polymorphic_allocator<Tp> {
+      public:
+        allocator() noexcept :
+            std::pmr::polymorphic_allocator<Tp>(current_resource()) {}
+        allocator(std::pmr::memory_resource *resource) noexcept :
+            std::pmr::polymorphic_allocator<Tp>(resource) {}
+        template <typename Up>
+        allocator(const allocator<Up> &other) noexcept :
+            std::pmr::polymorphic_allocator<Tp>(other.resource()) {}
+
+        allocator select_on_container_copy_construction() const { return {}; }
+    };
+
+    using string =
+        std::basic_string<char, std::char_traits<char>, allocator<char>>;
+
+    template <typename Tp>
+    using vector = std::vector<Tp, allocator<Tp>>;
+
+    // Destroys an object created by `allocate_unique()` and returns its memory.
+    struct resource_deleter {
+        std::pmr::memory_resource *resource;
+        size_t size;
+        size_t alignment;
+
+        template <typename Tp>
+        void operator()(Tp *ptr) const {
+            ptr->~Tp();
+            resource->deallocate(ptr, size, alignment);
+        }
+    };
+
+    template <typename Tp>
+    using unique_ptr = std::unique_ptr<Tp, resource_deleter>;
+
+    template <typename Tp, typename... ArgTs>
+    unique_ptr<Tp> allocate_unique(ArgTs &&...args) {
+        std::pmr::memory_resource *resource = current_resource();
+        void *ptr = resource->allocate(sizeof(Tp), alignof(Tp));
+        try {
+            ::new (ptr) Tp(std::forward<ArgTs>(args)...);
+        } catch (...) {
+            resource->deallocate(ptr, sizeof(Tp), alignof(Tp));
+            throw;
+        }
+        return unique_ptr<Tp>(
+            static_cast<Tp *>(ptr),
+            resource_deleter{resource, sizeof(Tp), alignof(Tp)});
     }
 
-    template <typename SrchT, typename IdxSeqT, size_t CurIdx, typename... Ts>
-    struct type_positions {};
+    template <typename StrT>
+    concept text_source = std::convertible_to<const StrT &, std::string_view>;
+
+    // The argument of the flag name and help text setters. A `std::string_view`
+    // is referred to, any other string, including string literals and other
+    // character arrays, is copied: whether an array has static storage cannot
+    // be told apart, and copying never dangles.
+    class text_arg {
+      public:
+        template <size_t N>
+        text_arg(const char (&value)[N]);
+        template <text_source StrT>
+            requires(!std::is_array_v<StrT>)
+        text_arg(const StrT &value);
+
+      private:
+        friend class text;
+
+        std::string_view _view;
+        bool _owning;
+    };
+
+    template <size_t N>
+    text_arg::text_arg(const char (&value)[N]) : _view{value}, _owning{true} {}
+
+    template <text_source StrT>
+        requires(!std::is_array_v<StrT>)
+    text_arg::text_arg(const StrT &value) :
+        _view{value}, _owning{!std::same_as<StrT, std::string_view>} {}
+
+    // one `text_arg` per element of a pack
+    template <typename>
+    using text_arg_for = text_arg;
 
-    template <typename SrchT, size_t CurIdx, size_t... Idx>
-    struct type_positions<SrchT, std::index_sequence<Idx...>, CurIdx> {
-        using type = std::index_sequence<Idx...>;
+    // Flag names and help texts, owning a copy unless `text_arg` allows a
+    // view.
+    class text {
+      public:
+        void assign(text_arg value);
+        std::string_view view() const;
+        bool empty() const;
+
+      private:
+        std::string_view _view;
+        string _owned;
+        bool _owning = false;
     };
 
-    template <
-        typename SrchT, typename CurT, typename... Ts, size_t CurIdx,
-        size_t... Idx>
-    struct type_positions<
-        SrchT, std::index_sequence<Idx...>, CurIdx, CurT, Ts...> {
-        using type = std::conditional_t<
-            std::is_same_v<std::decay_t<SrchT>, std::decay_t<CurT>>,
-            typename type_positions<
-                SrchT, std::index_sequence<Idx..., CurIdx>, CurIdx + 1,
-                Ts...>::type,
-            typename type_positions<
-                SrchT, std::index_sequence<Idx...>, CurIdx + 1, Ts...>::type>;
+    inline void text::assign(text_arg value) {
+        if (value._owning) {
+            _owned = value._view;
+            _owning = true;
+        } else {
+            _view = value._view;
+            _owned.clear();
+            _owning = false;
+        }
+    }
+
+    inline std::string_view text::view() const {
+        return _owning ? std::string_view(_owned) : _view;
+    }
+
+    inline bool text::empty() const { return view().empty(); }
+
+    template <size_t N>
+    struct arena_buffer {
+        alignas(std::max_align_t) std::byte _buffer[N];
     };
 
     template <typename SrchT, typename... Ts>
-    using type_positions_t =
-        typename type_positions<SrchT, std::index_sequence<>, 0, Ts...>::type;
+    constexpr size_t type_count =
+        (size_t{0} + ... +
+         std::is_same_v<std::decay_t<SrchT>, std::decay_t<Ts>>);
 }  // namespace _detail
 
 class meta;
@@ -120,6 +352,65 @@ struct information {
     virtual meta genmeta() = 0;
 };
 
+enum class error_kind {
+    unexpected_argument,
+    missing_value,
+    unexpected_value,
+    invalid_value,
+    used_multiple,
+    // a `greet::inplace_vector` is full
+    too_many_values,
+    missing_options,
+    recursive_response_file,
+    // not really errors, the user asked for `--help` or `--version`
+    display_help,
+    display_version,
+};
+
+/// The reason why parsing stopped, `message()` formats it on demand.
+struct error {
+    error_kind kind;
+    // the flag as the user wrote it, such as `-n` or `--name`
+    std::string flag;
+    // the offending value or argument
+    std::string value;
+    // the argument name of the option, empty if it doesn't need an argument
+    std::string argname;
+    // index of the offending token in the argument list
+    size_t index;
+    std::errc ec;
+    // flags with argument names of the missing required options
+    std::vector<std::string> missing;
+    // the subcommands the offending token belongs to, outermost first
+    std::vector<std::string> commands;
+    // long flags similar to an unexpected one, closest first
+    std::vector<std::string> suggestions;
+    // `path:line` of the config file the error comes from, empty otherwise
+    std::string location;
+
+    std::string message() const;
+};
+
+/// Base of argument groups whose `genmeta()` is a non-virtual function
+/// returning a `greet::static_meta`.
+struct static_information {
+    virtual std::string version() = 0;
+    virtual std::string description() = 0;
+};
+
+/// Pass `greet::abbreviations` to `greet::meta` to accept unambiguous
+/// prefixes of long flags, such as `--verb` for `--verbose`.
+struct abbreviations_t {
+    explicit abbreviations_t() = default;
+};
+
+inline constexpr abbreviations_t abbreviations{};
+
+namespace _detail {
+    template <typename OptT>
+    class opt_wrapper;
+}  // namespace _detail
+
 class counter {
   public:
     counter();
@@ -133,6 +424,9 @@ class counter {
     operator size_t();
 
   private:
+    // loads a snapshot without counting up to it
+    friend class _detail::opt_wrapper<counter>;
+
     size_t _counter;
 };
 
@@ -145,30 +439,309 @@ class ignored : public std::vector<std::string> {
     ignored &operator=(ignored &&) = default;
 };
 
+/// Like `ignored`, but only views the tail of the argument list instead of
+/// copying it, so it must not outlive the arguments.
+class ignored_view : public std::span<const char *const> {
+  public:
+    using std::span<const char *const>::span;
+    ignored_view() = default;
+    ignored_view(const ignored_view &) = default;
+    ignored_view(ignored_view &&) = default;
+    ignored_view &operator=(const ignored_view &) = default;
+    ignored_view &operator=(ignored_view &&) = default;
+};
+
+/// A monotonic memory resource for a parse session, the first `BufferSize`
+/// bytes come from the arena itself and everything is released at once when
+/// it is destroyed.
+template <size_t BufferSize = 8192>
+class arena : private _detail::arena_buffer<BufferSize>,
+              public std::pmr::monotonic_buffer_resource {
+  public:
+    explicit arena(
+        std::pmr::memory_resource *upstream = std::pmr::new_delete_resource());
+    arena(const arena &) = delete;
+};
+
+template <size_t BufferSize>
+arena<BufferSize>::arena(std::pmr::memory_resource *upstream) :
+    _detail::arena_buffer<BufferSize>{},
+    std::pmr::monotonic_buffer_resource(
+        this->_buffer, BufferSize, upstream) {}
+
+/// What kind of token the parser met, in the order of `_detail::argtype()`.
+enum class token_kind {
+    argument,
+    end_of_options,
+    short_flags,
+    long_flag,
+};
+
+/// An observer of `greet::parser` which ignores all events, observing with it
+/// is compiled out. Derive from it to handle only some of the events.
+struct null_observer {
+    // `genmeta()` built the schema
+    void on_schema(std::chrono::nanoseconds) {}
+    // a token was classified, values taken by options are not classified
+    void on_token(std::string_view, token_kind) {}
+    // a flag was looked up, `found` is false for a miss
+    void on_lookup(std::string_view, bool) {}
+    // a value was converted by its option
+    void on_conversion(std::string_view, std::errc, std::chrono::nanoseconds) {}
+    // required options were checked after the last token
+    void on_validation(bool, std::chrono::nanoseconds) {}
+    // `bytes` were allocated from the memory resource of the parser
+    void on_allocation(size_t) {}
+    // an argument list was parsed, `ok` is false if it failed
+    void on_parse(bool, std::chrono::nanoseconds) {}
+};
+
+template <typename ObserverT>
+concept parse_observer =
+    requires(ObserverT &observer, std::chrono::nanoseconds elapsed) {
+        observer.on_schema(elapsed);
+        observer.on_token(std::string_view{}, token_kind::argument);
+        observer.on_lookup(std::string_view{}, true);
+        observer.on_conversion(std::string_view{}, std::errc{}, elapsed);
+        observer.on_validation(true, elapsed);
+        observer.on_allocation(size_t{});
+        observer.on_parse(true, elapsed);
+    };
+
+/// The totals collected by `greet::parse_stats`.
+struct parse_totals {
+    size_t parses;
+    size_t failures;
+    size_t tokens;
+    size_t lookups;
+    size_t misses;
+    size_t conversions;
+    size_t allocations;
+    size_t allocated_bytes;
+    std::chrono::nanoseconds schema;
+    std::chrono::nanoseconds conversion;
+    std::chrono::nanoseconds validation;
+    std::chrono::nanoseconds parse;
+
+    std::string summary() const;
+};
+
+/// An observer which sums up the events, it may be shared by threads.
+class parse_stats {
+  public:
+    void on_schema(std::chrono::nanoseconds elapsed);
+    void on_token(std::string_view, token_kind);
+    void on_lookup(std::string_view, bool found);
+    void on_conversion(
+        std::string_view, std::errc, std::chrono::nanoseconds elapsed);
+    void on_validation(bool, std::chrono::nanoseconds elapsed);
+    void on_allocation(size_t bytes);
+    void on_parse(bool ok, std::chrono::nanoseconds elapsed);
+
+    parse_totals totals() const;
+
+  private:
+    enum {
+        PARSES,
+        FAILURES,
+        TOKENS,
+        LOOKUPS,
+        MISSES,
+        CONVERSIONS,
+        ALLOCATIONS,
+        ALLOCATED_BYTES,
+        SCHEMA_NS,
+        CONVERSION_NS,
+        VALIDATION_NS,
+        PARSE_NS,
+        COUNTERS,
+    };
+
+    void _add(size_t counter, uint64_t value);
+
+    std::array<std::atomic<uint64_t>, COUNTERS> _counters{};
+};
+
+inline void parse_stats::on_schema(std::chrono::nanoseconds elapsed) {
+    _add(SCHEMA_NS, elapsed.count());
+}
+
+inline void parse_stats::on_token(std::string_view, token_kind) {
+    _add(TOKENS, 1);
+}
+
+inline void parse_stats::on_lookup(std::string_view, bool found) {
+    _add(LOOKUPS, 1);
+    if (!found) _add(MISSES, 1);
+}
+
+inline void parse_stats::on_conversion(
+    std::string_view, std::errc, std::chrono::nanoseconds elapsed) {
+    _add(CONVERSIONS, 1);
+    _add(CONVERSION_NS, elapsed.count());
+}
+
+inline void parse_stats::on_validation(
+    bool, std::chrono::nanoseconds elapsed) {
+    _add(VALIDATION_NS, elapsed.count());
+}
+
+inline void parse_stats::on_allocation(size_t bytes) {
+    _add(ALLOCATIONS, 1);
+    _add(ALLOCATED_BYTES, bytes);
+}
+
+inline void parse_stats::on_parse(bool ok, std::chrono::nanoseconds elapsed) {
+    _add(PARSES, 1);
+    if (!ok) _add(FAILURES, 1);
+    _add(PARSE_NS, elapsed.count());
+}
+
+inline parse_totals parse_stats::totals() const {
+    auto get = [this](size_t counter) {
+        return _counters[counter].load(std::memory_order_relaxed);
+    };
+    auto ns = [&](size_t counter) {
+        return std::chrono::nanoseconds(static_cast<int64_t>(get(counter)));
+    };
+    return parse_totals{
+        .parses = get(PARSES),
+        .failures = get(FAILURES),
+        .tokens = get(TOKENS),
+        .lookups = get(LOOKUPS),
+        .misses = get(MISSES),
+        .conversions = get(CONVERSIONS),
+        .allocations = get(ALLOCATIONS),
+        .allocated_bytes = get(ALLOCATED_BYTES),
+        .schema = ns(SCHEMA_NS),
+        .conversion = ns(CONVERSION_NS),
+        .validation = ns(VALIDATION_NS),
+        .parse = ns(PARSE_NS),
+    };
+}
+
+inline void parse_stats::_add(size_t counter, uint64_t value) {
+    _counters[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+#ifdef GREET_DEFINITIONS
+GREET_INLINE std::string parse_totals::summary() const {
+    return std::format(
+        "{} parses ({} failed), {} tokens, {} lookups ({} missed), "
+        "{} conversions, {} allocations ({} bytes)\n"
+        "schema {} ns, parse {} ns, conversion {} ns, validation {} ns",
+        parses,
+        failures,
+        tokens,
+        lookups,
+        misses,
+        conversions,
+        allocations,
+        allocated_bytes,
+        schema.count(),
+        parse.count(),
+        conversion.count(),
+        validation.count());
+}
+#endif
+
 template <typename OptT>
 struct string_converter;
 
+namespace _detail {
+    template <typename OptT>
+    concept view_convertable = requires(std::string_view str) {
+        {
+            string_converter<OptT>::from_str(str)
+        } -> std::same_as<std::expected<OptT, std::errc>>;
+    };
+
+    // converters written before `std::string_view` was passed through
+    template <typename OptT>
+    concept cstr_convertable = requires(const char *str) {
+        {
+            string_converter<OptT>::from_str(str)
+        } -> std::same_as<std::expected<OptT, std::errc>>;
+    };
+}  // namespace _detail
+
 template <typename OptT>
-concept string_convertable = requires(OptT t, const char *str) {
-    {
-        string_converter<OptT>::from_str(str)
-    } -> std::same_as<std::expected<OptT, std::errc>>;
-    { string_converter<OptT>::to_str(t) } -> std::same_as<std::string>;
-};
+concept string_convertable =
+    (_detail::view_convertable<OptT> || _detail::cstr_convertable<OptT>) &&
+    requires(OptT t) {
+        { string_converter<OptT>::to_str(t) } -> std::same_as<std::string>;
+    };
+
+namespace _detail {
+    // `str` is not always null-terminated, so converters which only accept
+    // `const char *` get a null-terminated copy of it.
+    template <string_convertable OptT>
+    inline auto from_str(std::string_view str)
+        -> std::expected<OptT, std::errc> {
+        if constexpr (view_convertable<OptT>)
+            return string_converter<OptT>::from_str(str);
+        else
+            return string_converter<OptT>::from_str(std::string(str).c_str());
+    }
+
+    // whether `Tp` is a `greet::inplace_vector`
+    template <typename Tp>
+    inline constexpr bool fixed_capacity = false;
+
+    /// Append the `delimiter` separated elements of `value` to `target`, either
+    /// all of them or none if any fails to convert or does not fit.
+    template <typename ContainerT>
+    std::errc append_split(
+        ContainerT &target, std::string_view value, char delimiter) {
+        using OptT = typename ContainerT::value_type;
+        // count the elements first, so a vector grows at most once
+        const char *begin = value.data(), *end = begin + value.size();
+        size_t count = 1;
+        for (const void *hit;
+             (hit = std::memchr(begin, delimiter, end - begin));
+             ++count)
+            begin = static_cast<const char *>(hit) + 1;
+
+        size_t old_size = target.size();
+        if constexpr (fixed_capacity<ContainerT>) {
+            if (target.capacity() - old_size < count)
+                return std::errc::no_buffer_space;
+        } else if (target.capacity() < old_size + count) {
+            target.reserve(std::max(old_size + count, 2 * target.capacity()));
+        }
+        auto fail = [&](std::errc ec) {
+            target.resize(old_size);
+            return ec;
+        };
+        // each element is converted as soon as its end is found
+        for (const char *pos = value.data();;) {
+            auto hit = static_cast<const char *>(
+                std::memchr(pos, delimiter, end - pos));
+            auto expt = from_str<OptT>(std::string_view(pos, hit ? hit : end));
+            if (!expt) return fail(expt.error());
+            target.emplace_back(std::move(expt.value()));
+            if (!hit) break;
+            pos = hit + 1;
+        }
+        return {};
+    }
+}  // namespace _detail
 
 template <_detail::integer OptT>
 struct string_converter<OptT> {
-    static auto from_str(const char *str) -> std::expected<OptT, std::errc> {
+    static auto from_str(std::string_view str)
+        -> std::expected<OptT, std::errc> {
         OptT v{};
-        const char *end = _detail::strend(str);
+        const char *begin = str.data();
+        const char *end = begin + str.size();
         std::from_chars_result result;
-        if (str[0] == '0')
+        if (str.size() > 1 && str[0] == '0')
             if (str[1] == 'x')
-                result = std::from_chars(str + 2, end, v, 16);
+                result = std::from_chars(begin + 2, end, v, 16);
             else
-                result = std::from_chars(str + 1, end, v, 8);
+                result = std::from_chars(begin + 1, end, v, 8);
         else
-            result = std::from_chars(str, end, v);
+            result = std::from_chars(begin, end, v);
         auto [ptr, ec] = result;
         if (ec == std::errc{})
             if (ptr == end)
@@ -186,10 +759,11 @@ struct string_converter<OptT> {
 
 template <_detail::float_pointer OptT>
 struct string_converter<OptT> {
-    static auto from_str(const char *str) -> std::expected<OptT, std::errc> {
+    static auto from_str(std::string_view str)
+        -> std::expected<OptT, std::errc> {
         OptT v{};
-        const char *end = _detail::strend(str);
-        auto [ptr, ec] = std::from_chars(str, end, v);
+        const char *end = str.data() + str.size();
+        auto [ptr, ec] = std::from_chars(str.data(), end, v);
         if (ec == std::errc{})
             if (ptr == end)
                 return v;
@@ -206,10 +780,11 @@ struct string_converter<OptT> {
 
 template <>
 struct string_converter<char> {
-    static auto from_str(const char *str) -> std::expected<char, std::errc> {
-        if (std::strlen(str) != 1)
+    static auto from_str(std::string_view str)
+        -> std::expected<char, std::errc> {
+        if (str.size() != 1)
             return std::unexpected(std::errc::invalid_argument);
-        return *str;
+        return str[0];
     }
 
     static std::string to_str(const char &value) {
@@ -217,19 +792,32 @@ struct string_converter<char> {
     }
 };
 
+// Only views the argument, which is null-terminated if it comes from argv.
 template <>
 struct string_converter<const char *> {
-    static auto from_str(const char *str)
+    static auto from_str(std::string_view str)
         -> std::expected<const char *, std::errc> {
-        return str;
+        return str.data();
     }
 
     static std::string to_str(const char *const &value) { return value; }
 };
 
+template <>
+struct string_converter<std::string_view> {
+    static auto from_str(std::string_view str)
+        -> std::expected<std::string_view, std::errc> {
+        return str;
+    }
+
+    static std::string to_str(const std::string_view &value) {
+        return std::string(value);
+    }
+};
+
 template <>
 struct string_converter<std::string> {
-    static auto from_str(const char *str)
+    static auto from_str(std::string_view str)
         -> std::expected<std::string, std::errc> {
         return std::string(str);
     }
@@ -245,14 +833,350 @@ concept args_group =
 template <typename OptT>
 concept option = std::semiregular<OptT> && string_convertable<OptT>;
 
+/// When a `greet::lazy` option converts its value.
+enum class lazy_mode {
+    // on first access, an invalid value is only noticed there
+    deferred,
+    // while parsing, an invalid value is a parse error
+    validated,
+};
+
+/// A NORMAL type option which keeps the raw token and converts it to `OptT`
+/// on first access, the result is cached. Accessing it is not thread-safe.
+template <option OptT, lazy_mode Mode = lazy_mode::deferred>
+class lazy {
+  public:
+    lazy();
+    lazy(OptT value);
+
+    // the converted value, or why the token could not be converted
+    const std::expected<OptT, std::errc> &get() const;
+    // the converted value, throws `std::bad_expected_access` if invalid
+    const OptT &operator*() const;
+    const OptT *operator->() const;
+    // the token given by the user, empty if the option was not used
+    std::string_view raw() const;
+
+  private:
+    friend struct string_converter<lazy>;
+
+    std::string _raw;
+    mutable std::optional<std::expected<OptT, std::errc>> _value;
+};
+
+template <option OptT, lazy_mode Mode>
+lazy<OptT, Mode>::lazy() : _raw{}, _value(OptT{}) {}
+
+template <option OptT, lazy_mode Mode>
+lazy<OptT, Mode>::lazy(OptT value) : _raw{}, _value(std::move(value)) {}
+
+template <option OptT, lazy_mode Mode>
+auto lazy<OptT, Mode>::get() const -> const std::expected<OptT, std::errc> & {
+    if (!_value) _value = _detail::from_str<OptT>(_raw);
+    return *_value;
+}
+
+template <option OptT, lazy_mode Mode>
+const OptT &lazy<OptT, Mode>::operator*() const {
+    return get().value();
+}
+
+template <option OptT, lazy_mode Mode>
+const OptT *lazy<OptT, Mode>::operator->() const {
+    return &get().value();
+}
+
+template <option OptT, lazy_mode Mode>
+std::string_view lazy<OptT, Mode>::raw() const {
+    return _raw;
+}
+
+template <option OptT, lazy_mode Mode>
+struct string_converter<lazy<OptT, Mode>> {
+    static auto from_str(std::string_view str)
+        -> std::expected<lazy<OptT, Mode>, std::errc> {
+        lazy<OptT, Mode> result;
+        result._raw = str;
+        result._value.reset();
+        if constexpr (Mode == lazy_mode::validated) {
+            result._value = _detail::from_str<OptT>(str);
+            if (!result._value.value())
+                return std::unexpected(result._value.value().error());
+        }
+        return result;
+    }
+
+    static std::string to_str(const lazy<OptT, Mode> &value) {
+        if (!value._raw.empty() || !value._value || !value._value.value())
+            return value._raw;
+        return string_converter<OptT>::to_str(value._value.value().value());
+    }
+};
+
+/// A VECTOR type option holding at most `N` values in place, so it never
+/// allocates. Giving it more values is a `too_many_values` error.
+template <option OptT, size_t N>
+class inplace_vector {
+  public:
+    using value_type = OptT;
+    using iterator = OptT *;
+    using const_iterator = const OptT *;
+
+    inplace_vector();
+
+    static constexpr size_t capacity() { return N; }
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    bool full() const { return _size == N; }
+
+    OptT *data() { return _values.data(); }
+    const OptT *data() const { return _values.data(); }
+    iterator begin() { return data(); }
+    iterator end() { return data() + _size; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + _size; }
+    OptT &operator[](size_t index) { return _values[index]; }
+    const OptT &operator[](size_t index) const { return _values[index]; }
+
+    // it must not be `full()`
+    template <typename... ArgTs>
+    OptT &emplace_back(ArgTs &&...args);
+    // `count` must not exceed `N`, the dropped values are reset
+    void resize(size_t count);
+    void clear();
+
+  private:
+    std::array<OptT, N> _values;
+    size_t _size;
+};
+
+template <option OptT, size_t N>
+inplace_vector<OptT, N>::inplace_vector() : _values{}, _size{0} {}
+
+template <option OptT, size_t N>
+template <typename... ArgTs>
+OptT &inplace_vector<OptT, N>::emplace_back(ArgTs &&...args) {
+    OptT &slot = _values[_size++];
+    slot = OptT(std::forward<ArgTs>(args)...);
+    return slot;
+}
+
+template <option OptT, size_t N>
+void inplace_vector<OptT, N>::resize(size_t count) {
+    for (size_t i = count; i < _size; ++i) _values[i] = OptT{};
+    _size = count;
+}
+
+template <option OptT, size_t N>
+void inplace_vector<OptT, N>::clear() {
+    resize(0);
+}
+
+namespace _detail {
+    template <option OptT, size_t N>
+    inline constexpr bool fixed_capacity<inplace_vector<OptT, N>> = true;
+
+    // the error of a value which `set()` rejected with `ec`
+    inline error_kind value_error(std::errc ec) {
+        return ec == std::errc::no_buffer_space ? error_kind::too_many_values
+                                                : error_kind::invalid_value;
+    }
+
+    // Append `value` converted to an element of `target`, a full
+    // `greet::inplace_vector` rejects it with `std::errc::no_buffer_space`.
+    template <typename ContainerT>
+    std::errc append_value(ContainerT &target, std::string_view value) {
+        using OptT = typename ContainerT::value_type;
+        if constexpr (fixed_capacity<ContainerT>)
+            if (target.full()) return std::errc::no_buffer_space;
+        std::expected<OptT, std::errc> expt = from_str<OptT>(value);
+        if (!expt) return expt.error();
+        target.emplace_back(std::move(expt.value()));
+        return {};
+    }
+
+    // `greet::opt(...).deferred()` without an execution policy
+    struct sequenced {};
+
+    /// Append the elements of all of `values` to `target`, converted with
+    /// `PolicyT`. It is sized for them first, and on failure it is restored
+    /// and `failed` is the position of the first value in error.
+    template <typename OptT, typename PolicyT>
+    std::errc convert_bulk(
+        std::vector<OptT> &target, std::span<const std::string_view> values,
+        char delimiter, size_t &failed) {
+        // the elements and the positions of the values they come from
+        std::vector<std::pair<std::string_view, size_t>> slices;
+        slices.reserve(values.size());
+        for (size_t i = 0; i < values.size(); ++i) {
+            std::string_view value = values[i];
+            while (delimiter) {
+                size_t pos = value.find(delimiter);
+                if (pos == std::string_view::npos) break;
+                slices.emplace_back(value.substr(0, pos), i);
+                value.remove_prefix(pos + 1);
+            }
+            slices.emplace_back(value, i);
+        }
+
+        size_t old_size = target.size();
+        target.resize(old_size + slices.size());
+        OptT *out = target.data() + old_size;
+        std::vector<std::errc> errors(slices.size());
+        auto convert = [&](std::errc &ec) {
+            size_t i = &ec - errors.data();
+            auto expt = from_str<OptT>(slices[i].first);
+            if (expt)
+                out[i] = std::move(expt.value());
+            else
+                ec = expt.error();
+        };
+        if constexpr (std::same_as<PolicyT, sequenced>) {
+            std::for_each(errors.begin(), errors.end(), convert);
+        } else {
+            PolicyT policy{};
+            std::for_each(policy, errors.begin(), errors.end(), convert);
+        }
+
+        auto bad = std::ranges::find_if(
+            errors, [](std::errc ec) { return ec != std::errc{}; });
+        if (bad == errors.end()) return {};
+        failed = slices[bad - errors.begin()].second;
+        target.resize(old_size);
+        return *bad;
+    }
+}  // namespace _detail
+
+/// The names of the values of the enumeration `EnumT`, specialize it with a
+/// `values` array of name and value pairs to use `EnumT` as a NORMAL option
+/// taking one of the names:
+///
+///     template <>
+///     struct greet::choices<codec> {
+///         static constexpr std::array values{
+///             std::pair{"h264", codec::h264},
+///             std::pair{"vp9", codec::vp9},
+///         };
+///     };
+template <typename EnumT>
+struct choices;
+
+namespace _detail {
+    template <typename EnumT>
+    concept choice = std::is_enum_v<EnumT> && requires {
+        {
+            choices<EnumT>::values[0].first
+        } -> std::convertible_to<std::string_view>;
+        { choices<EnumT>::values[0].second } -> std::convertible_to<EnumT>;
+        std::size(choices<EnumT>::values);
+    };
+
+    // FNV-1a starting from `seed`
+    constexpr uint64_t seeded_hash(std::string_view name, uint64_t seed) {
+        uint64_t hash = 0xcbf29ce484222325 ^ seed;
+        for (unsigned char c : name) {
+            hash ^= c;
+            hash *= 0x100000001b3;
+        }
+        return hash;
+    }
+
+    // A perfect hash of the names of `EnumT` found at compile time, each
+    // name has a slot of its own, so a lookup hashes once and compares once.
+    template <choice EnumT>
+    class choice_table {
+      public:
+        static constexpr size_t size = std::size(choices<EnumT>::values);
+        static_assert(size > 0, "`greet::choices` needs at least one value.");
+        static_assert(size < 256, "`greet::choices` has too many values.");
+
+        static constexpr auto names = [] {
+            std::array<std::string_view, size> result{};
+            for (size_t i = 0; i < size; ++i)
+                result[i] = choices<EnumT>::values[i].first;
+            return result;
+        }();
+
+        static constexpr bool unique = [] {
+            for (size_t i = 0; i < size; ++i)
+                for (size_t j = 0; j < i; ++j)
+                    if (names[i] == names[j]) return false;
+            return true;
+        }();
+        static_assert(
+            unique, "a name of `greet::choices` is used more than once.");
+
+        static constexpr std::optional<EnumT> find(std::string_view name) {
+            uint8_t slot = _table.slots[seeded_hash(name, _table.seed) & _mask];
+            if (slot == 0 || names[slot - 1] != name) return std::nullopt;
+            return static_cast<EnumT>(choices<EnumT>::values[slot - 1].second);
+        }
+
+      private:
+        // sparse enough that a seed is usually found at the first tries
+        static constexpr size_t _buckets = std::bit_ceil(size * size);
+        static constexpr size_t _mask = _buckets - 1;
+
+        struct table {
+            uint64_t seed;
+            // index of the name plus one, zero if empty
+            std::array<uint8_t, _buckets> slots;
+        };
+
+        static constexpr table _table = [] {
+            // duplicated names never fit, the assertion above reports them
+            if (!unique) return table{};
+            for (uint64_t seed = 0;; ++seed) {
+                table result{.seed = seed, .slots = {}};
+                bool perfect = true;
+                for (size_t i = 0; i < size && perfect; ++i) {
+                    size_t bucket = seeded_hash(names[i], seed) & _mask;
+                    auto &slot = result.slots[bucket];
+                    perfect = slot == 0;
+                    slot = static_cast<uint8_t>(i + 1);
+                }
+                if (perfect) return result;
+            }
+        }();
+    };
+}  // namespace _detail
+
+template <_detail::choice EnumT>
+struct string_converter<EnumT> {
+    static auto from_str(std::string_view str)
+        -> std::expected<EnumT, std::errc> {
+        auto value = _detail::choice_table<EnumT>::find(str);
+        if (!value) return std::unexpected(std::errc::invalid_argument);
+        return *value;
+    }
+
+    static std::string to_str(const EnumT &value) {
+        for (const auto &[name, item] : choices<EnumT>::values)
+            if (static_cast<EnumT>(item) == value) return std::string(name);
+        return std::to_string(std::to_underlying(value));
+    }
+};
+
 namespace _detail {
+    // the names a NORMAL or VECTOR option of `OptT` accepts, empty if any
+    template <typename OptT>
+    std::span<const std::string_view> choice_names() {
+        if constexpr (choice<OptT>)
+            return choice_table<OptT>::names;
+        else
+            return {};
+    }
+
     enum {
         NORMAL,
         BOOLEAN,
         COUNTER,
         VECTOR,
+        COMMAND,
     };
 
+    class token_stream;
+
     template <typename OptT>
     struct opt_type {};
 
@@ -276,34 +1200,265 @@ namespace _detail {
         static constexpr size_t type = VECTOR;
     };
 
-    template <typename OptT>
-    constexpr size_t opt_type_v = opt_type<OptT>::type;
+    template <option OptT, size_t N>
+    struct opt_type<inplace_vector<OptT, N>> {
+        static constexpr size_t type = VECTOR;
+    };
 
-    class opt_base {
-      public:
-        opt_base();
-        opt_base(const opt_base &) = default;
+    // Storage of `greet::opt_sink()`, values are handed to `FnT` one by one
+    // instead of being stored in the argument group.
+    template <typename FnT>
+    struct sink {};
+
+    template <typename FnT>
+    struct opt_type<sink<FnT>> {
+        static constexpr size_t type = VECTOR;
+    };
+
+    // Storage of `-h` and `-V`, they only record whether they are set, so
+    // they are not bound to any member of the argument group.
+    struct builtin_flag {};
+
+    template <>
+    struct opt_type<builtin_flag> {
+        static constexpr size_t type = BOOLEAN;
+    };
+
+    template <typename OptT>
+    constexpr size_t opt_type_v = opt_type<OptT>::type;
+
+    // The encoding of `greet::save()`, numbers are stored in the native byte
+    // order and sizes as `uint64_t`.
+    template <typename Tp>
+    void save_raw(const Tp &value, std::string &out) {
+        out.append(reinterpret_cast<const char *>(&value), sizeof(Tp));
+    }
+
+    template <typename Tp>
+    bool load_raw(Tp &value, std::string_view &in) {
+        if (in.size() < sizeof(Tp)) return false;
+        std::memcpy(&value, in.data(), sizeof(Tp));
+        in.remove_prefix(sizeof(Tp));
+        return true;
+    }
+
+    inline void save_text(std::string_view text, std::string &out) {
+        save_raw<uint64_t>(text.size(), out);
+        out.append(text);
+    }
+
+    inline bool load_text(std::string_view &text, std::string_view &in) {
+        uint64_t size;
+        if (!load_raw(size, in) || in.size() < size) return false;
+        text = in.substr(0, size);
+        in.remove_prefix(size);
+        return true;
+    }
+
+    // numbers are copied as they are, they may also be copied in bulk
+    template <typename Tp>
+    concept raw_value =
+        (std::is_arithmetic_v<Tp> || std::is_enum_v<Tp>) &&
+        !std::same_as<Tp, bool>;
+
+    // whether a raw `value` is one its type takes, an enumeration listed in
+    // `greet::choices` only takes the listed values
+    template <typename Tp>
+    bool valid_raw(const Tp &value) {
+        if constexpr (choice<Tp>)
+            return std::ranges::any_of(choices<Tp>::values, [&](auto &item) {
+                return static_cast<Tp>(item.second) == value;
+            });
+        else
+            return true;
+    }
+
+    // a bool is stored as one byte, anything but 0 and 1 is malformed
+    inline void save_bool(bool value, std::string &out) {
+        out.push_back(value ? '\1' : '\0');
+    }
+
+    inline bool load_bool(bool &value, std::string_view &in) {
+        if (in.empty() || static_cast<unsigned char>(in[0]) > 1) return false;
+        value = in[0] == '\1';
+        in.remove_prefix(1);
+        return true;
+    }
+
+    template <typename Tp>
+    void save_value(const Tp &value, std::string &out) {
+        if constexpr (std::same_as<Tp, bool>) {
+            save_bool(value, out);
+        } else if constexpr (raw_value<Tp>) {
+            save_raw(value, out);
+        } else if constexpr (std::same_as<Tp, std::string> ||
+                             std::same_as<Tp, std::string_view>) {
+            save_text(value, out);
+        } else if constexpr (std::same_as<Tp, const char *>) {
+            save_bool(value != nullptr, out);
+            if (value) {
+                save_text(value, out);
+                out.push_back('\0');
+            }
+        } else {
+            save_text(string_converter<Tp>::to_str(value), out);
+        }
+    }
+
+    // Views such as `std::string_view` refer to `in` after loading.
+    template <typename Tp>
+    bool load_value(Tp &value, std::string_view &in) {
+        if constexpr (std::same_as<Tp, bool>) {
+            return load_bool(value, in);
+        } else if constexpr (raw_value<Tp>) {
+            return load_raw(value, in) && valid_raw(value);
+        } else if constexpr (std::same_as<Tp, const char *>) {
+            bool present;
+            if (!load_bool(present, in)) return false;
+            std::string_view text;
+            if (!present) {
+                value = nullptr;
+            } else if (load_text(text, in) && in.starts_with('\0')) {
+                value = text.data();
+                in.remove_prefix(1);
+            } else {
+                return false;
+            }
+            return true;
+        } else {
+            std::string_view text;
+            if (!load_text(text, in)) return false;
+            if constexpr (std::same_as<Tp, std::string> ||
+                          std::same_as<Tp, std::string_view>) {
+                value = Tp(text);
+            } else {
+                auto expt = from_str<Tp>(text);
+                if (!expt) return false;
+                value = std::move(expt.value());
+            }
+            return true;
+        }
+    }
+
+    template <typename ContainerT>
+    void save_values(const ContainerT &values, std::string &out) {
+        using Tp = typename ContainerT::value_type;
+        save_raw<uint64_t>(values.size(), out);
+        if constexpr (raw_value<Tp>)
+            out.append(
+                reinterpret_cast<const char *>(values.data()),
+                values.size() * sizeof(Tp));
+        else
+            for (const Tp &value : values) save_value(value, out);
+    }
+
+    template <typename ContainerT>
+    bool load_values(ContainerT &values, std::string_view &in) {
+        using Tp = typename ContainerT::value_type;
+        uint64_t size;
+        if (!load_raw(size, in)) return false;
+        if constexpr (fixed_capacity<ContainerT>)
+            if (size > values.capacity()) return false;
+        if constexpr (raw_value<Tp>) {
+            if (in.size() / sizeof(Tp) < size) return false;
+            values.resize(size);
+            std::memcpy(values.data(), in.data(), size * sizeof(Tp));
+            in.remove_prefix(size * sizeof(Tp));
+            if constexpr (choice<Tp>)
+                if (!std::ranges::all_of(values, valid_raw<Tp>)) return false;
+        } else {
+            // every value takes at least one byte
+            if (in.size() < size) return false;
+            values.clear();
+            if constexpr (!fixed_capacity<ContainerT>) values.reserve(size);
+            for (uint64_t i = 0; i < size; ++i)
+                if (!load_value(values.emplace_back(), in)) return false;
+        }
+        return true;
+    }
+
+    // a name of `Tp` for the schema hash, stable within one build
+    template <typename Tp>
+    std::string_view type_name() {
+        return std::source_location::current().function_name();
+    }
+
+    // FNV-1a
+    inline void hash_bytes(uint64_t &hash, std::string_view bytes) {
+        for (unsigned char c : bytes) {
+            hash ^= c;
+            hash *= 0x100000001b3;
+        }
+    }
+
+    inline uint64_t hash_name(std::string_view name) {
+        uint64_t hash = 0xcbf29ce484222325;
+        hash_bytes(hash, name);
+        return hash;
+    }
+
+    class opt_base {
+      public:
+        opt_base();
+        opt_base(const opt_base &) = default;
         opt_base(opt_base &&other);
         virtual ~opt_base() = default;
         opt_base &operator=(const opt_base &) = default;
         opt_base &operator=(opt_base &&other);
 
         inline char get_shrt() const;
-        inline const std::string &get_lng() const;
-        inline const std::string &get_about() const;
-        inline bool already_set() const;
-        virtual const std::string &get_argname() const;
+        inline std::string_view get_lng() const;
+        inline std::string_view get_about() const;
+        inline std::string_view get_env() const;
+        virtual std::string_view get_argname() const;
         virtual bool get_required() const;
         virtual bool get_allow_hyphen() const;
         virtual std::string get_def() const;
-        virtual std::errc set(const char *value = nullptr) = 0;
+        // Store `value` into the argument group `offset` bytes away from the
+        // bound one, the schema itself is never modified.
+        virtual std::errc set(
+            std::ptrdiff_t offset, std::string_view value = {}) const = 0;
+        // Copy the value of the argument group `from` bytes away into the one
+        // `to` bytes away, options without a bound value do nothing.
+        virtual void assign(std::ptrdiff_t to, std::ptrdiff_t from) const;
+        // Append the bound value to `out` or read it back from the front of
+        // `in`, see `greet::save()`, options without a bound value do
+        // nothing. `load()` returns false if `in` is malformed.
+        virtual void save(std::ptrdiff_t offset, std::string &out) const;
+        virtual bool load(std::ptrdiff_t offset, std::string_view &in) const;
+        // the type of the bound value, a part of the schema hash
+        virtual std::string_view value_type() const;
+        // the only values it accepts, see `greet::choices`
+        virtual std::span<const std::string_view> choices() const;
+        // whether its values are converted in bulk after the argument list
+        // is scanned, see `deferred()`
+        virtual bool get_deferred() const;
+        // Convert and append all of `values`, `failed` is the position of
+        // the first one which cannot be converted.
+        virtual std::errc set_many(
+            std::ptrdiff_t offset, std::span<const std::string_view> values,
+            size_t &failed) const;
         virtual bool need_argument() const;
+        // only subcommands override these, see `greet::subcommands`
+        virtual auto command(
+            std::ptrdiff_t offset, std::string_view name,
+            token_stream &tokens) const -> std::expected<bool, error>;
+        virtual auto command_list() const
+            -> vector<std::pair<std::string_view, string>>;
+        // the names alone, without building the argument groups
+        virtual auto command_names() const -> vector<std::string_view>;
+        virtual void report_command(
+            std::span<const std::string> path, std::string_view program_name,
+            const error &err) const;
+        virtual bool complete_command(
+            std::span<const char *const> words, string &out) const;
 
       protected:
         char _shrt;
-        std::string _lng;
-        std::string _about;
-        bool _set_flag;
+        text _lng;
+        text _about;
+        // the environment variable to fall back to, see `env()`
+        text _env;
     };
 
     template <typename OptT>
@@ -323,12 +1478,15 @@ namespace _detail {
 
         opt_wrapper &shrt(char value) &;
         opt_wrapper &&shrt(char value) &&;
-        opt_wrapper &lng(const std::string &value) &;
-        opt_wrapper &&lng(const std::string &value) &&;
-        opt_wrapper &about(const std::string &value) &;
-        opt_wrapper &&about(const std::string &value) &&;
-        opt_wrapper &argname(const std::string &value) &;
-        opt_wrapper &&argname(const std::string &value) &&;
+        opt_wrapper &lng(text_arg value) &;
+        opt_wrapper &&lng(text_arg value) &&;
+        opt_wrapper &about(text_arg value) &;
+        opt_wrapper &&about(text_arg value) &&;
+        // fall back to the environment variable `value` if not given
+        opt_wrapper &env(text_arg value) &;
+        opt_wrapper &&env(text_arg value) &&;
+        opt_wrapper &argname(text_arg value) &;
+        opt_wrapper &&argname(text_arg value) &&;
         opt_wrapper &required() &;
         opt_wrapper &&required() &&;
         opt_wrapper &allow_hyphen() &;
@@ -341,17 +1499,23 @@ namespace _detail {
             requires std::constructible_from<OptT, DefT...>;
 
       private:
-        const std::string &get_argname() const override;
+        std::string_view get_argname() const override;
         bool get_required() const override;
         bool get_allow_hyphen() const override;
         std::string get_def() const override;
-        std::errc set(const char *value = nullptr) override;
+        std::errc set(
+            std::ptrdiff_t offset, std::string_view value = {}) const override;
+        void assign(std::ptrdiff_t to, std::ptrdiff_t from) const override;
+        void save(std::ptrdiff_t offset, std::string &out) const override;
+        bool load(std::ptrdiff_t offset, std::string_view &in) const override;
+        std::string_view value_type() const override;
+        std::span<const std::string_view> choices() const override;
         bool need_argument() const override;
 
         std::reference_wrapper<OptT> _optref;
         bool _required;
         bool _allow_hyphen;
-        std::string _argname;
+        text _argname;
     };
 
     template <>
@@ -366,13 +1530,21 @@ namespace _detail {
 
         opt_wrapper &shrt(char value) &;
         opt_wrapper &&shrt(char value) &&;
-        opt_wrapper &lng(const std::string &value) &;
-        opt_wrapper &&lng(const std::string &value) &&;
-        opt_wrapper &about(const std::string &value) &;
-        opt_wrapper &&about(const std::string &value) &&;
+        opt_wrapper &lng(text_arg value) &;
+        opt_wrapper &&lng(text_arg value) &&;
+        opt_wrapper &about(text_arg value) &;
+        opt_wrapper &&about(text_arg value) &&;
+        // fall back to the environment variable `value` if not given
+        opt_wrapper &env(text_arg value) &;
+        opt_wrapper &&env(text_arg value) &&;
 
       private:
-        std::errc set(const char *value = nullptr) override;
+        std::errc set(
+            std::ptrdiff_t offset, std::string_view value = {}) const override;
+        void assign(std::ptrdiff_t to, std::ptrdiff_t from) const override;
+        void save(std::ptrdiff_t offset, std::string &out) const override;
+        bool load(std::ptrdiff_t offset, std::string_view &in) const override;
+        std::string_view value_type() const override;
 
         std::reference_wrapper<bool> _optref;
     };
@@ -389,17 +1561,41 @@ namespace _detail {
 
         opt_wrapper &shrt(char value) &;
         opt_wrapper &&shrt(char value) &&;
-        opt_wrapper &lng(const std::string &value) &;
-        opt_wrapper &&lng(const std::string &value) &&;
-        opt_wrapper &about(const std::string &value) &;
-        opt_wrapper &&about(const std::string &value) &&;
+        opt_wrapper &lng(text_arg value) &;
+        opt_wrapper &&lng(text_arg value) &&;
+        opt_wrapper &about(text_arg value) &;
+        opt_wrapper &&about(text_arg value) &&;
+        // fall back to the environment variable `value` if not given
+        opt_wrapper &env(text_arg value) &;
+        opt_wrapper &&env(text_arg value) &&;
 
       private:
-        std::errc set(const char *value = nullptr) override;
+        std::errc set(
+            std::ptrdiff_t offset, std::string_view value = {}) const override;
+        void assign(std::ptrdiff_t to, std::ptrdiff_t from) const override;
+        void save(std::ptrdiff_t offset, std::string &out) const override;
+        bool load(std::ptrdiff_t offset, std::string_view &in) const override;
+        std::string_view value_type() const override;
 
         std::reference_wrapper<counter> _optref;
     };
 
+    template <>
+    class opt_wrapper<builtin_flag> : public opt_base {
+      public:
+        opt_wrapper(
+            char shrt, std::string_view lng, std::string_view about);
+        opt_wrapper(const opt_wrapper &) = default;
+        opt_wrapper(opt_wrapper &&other) = default;
+        ~opt_wrapper() = default;
+        opt_wrapper &operator=(const opt_wrapper &) = default;
+        opt_wrapper &operator=(opt_wrapper &&other) = default;
+
+      private:
+        std::errc set(
+            std::ptrdiff_t offset, std::string_view value = {}) const override;
+    };
+
     template <option OptT>
     class opt_wrapper<std::vector<OptT>> : public opt_base {
       public:
@@ -412,24 +1608,131 @@ namespace _detail {
 
         opt_wrapper &shrt(char value) &;
         opt_wrapper &&shrt(char value) &&;
-        opt_wrapper &lng(const std::string &value) &;
-        opt_wrapper &&lng(const std::string &value) &&;
-        opt_wrapper &about(const std::string &value) &;
-        opt_wrapper &&about(const std::string &value) &&;
-        opt_wrapper &argname(const std::string &value) &;
-        opt_wrapper &&argname(const std::string &value) &&;
+        opt_wrapper &lng(text_arg value) &;
+        opt_wrapper &&lng(text_arg value) &&;
+        opt_wrapper &about(text_arg value) &;
+        opt_wrapper &&about(text_arg value) &&;
+        // fall back to the environment variable `value` if not given
+        opt_wrapper &env(text_arg value) &;
+        opt_wrapper &&env(text_arg value) &&;
+        opt_wrapper &argname(text_arg value) &;
+        opt_wrapper &&argname(text_arg value) &&;
         opt_wrapper &allow_hyphen() &;
         opt_wrapper &&allow_hyphen() &&;
+        // split each value at `value` into several elements
+        opt_wrapper &delimiter(char value) &
+            requires(!std::same_as<OptT, const char *>);
+        opt_wrapper &&delimiter(char value) &&
+            requires(!std::same_as<OptT, const char *>);
+        // Convert the values once the argument list is scanned, into a
+        // vector sized for all of them. Pass an execution policy such as
+        // `std::execution::par` to convert them in parallel, which needs
+        // `<execution>`.
+        opt_wrapper &deferred() &;
+        opt_wrapper &&deferred() &&;
+        template <typename PolicyT>
+        opt_wrapper &deferred(PolicyT policy) &;
+        template <typename PolicyT>
+        opt_wrapper &&deferred(PolicyT policy) &&;
 
       private:
-        const std::string &get_argname() const override;
+        using bulk_fn = std::errc (*)(
+            std::vector<OptT> &, std::span<const std::string_view>, char,
+            size_t &);
+
+        std::string_view get_argname() const override;
         bool get_allow_hyphen() const override;
-        std::errc set(const char *value = nullptr) override;
+        std::errc set(
+            std::ptrdiff_t offset, std::string_view value = {}) const override;
+        void assign(std::ptrdiff_t to, std::ptrdiff_t from) const override;
+        void save(std::ptrdiff_t offset, std::string &out) const override;
+        bool load(std::ptrdiff_t offset, std::string_view &in) const override;
+        std::string_view value_type() const override;
+        std::span<const std::string_view> choices() const override;
+        bool get_deferred() const override;
+        std::errc set_many(
+            std::ptrdiff_t offset, std::span<const std::string_view> values,
+            size_t &failed) const override;
         bool need_argument() const override;
 
         std::reference_wrapper<std::vector<OptT>> _optref;
         bool _allow_hyphen;
-        std::string _argname;
+        char _delimiter;
+        text _argname;
+        // converts deferred values, null if they are converted one by one
+        bulk_fn _bulk;
+    };
+
+    template <option OptT, size_t N>
+    class opt_wrapper<inplace_vector<OptT, N>> : public opt_base {
+      public:
+        opt_wrapper(inplace_vector<OptT, N> &optref);
+        opt_wrapper(const opt_wrapper &) = default;
+        opt_wrapper(opt_wrapper &&other);
+        ~opt_wrapper() = default;
+        opt_wrapper &operator=(const opt_wrapper &) = default;
+        opt_wrapper &operator=(opt_wrapper &&other);
+
+        opt_wrapper &shrt(char value) &;
+        opt_wrapper &&shrt(char value) &&;
+        opt_wrapper &lng(text_arg value) &;
+        opt_wrapper &&lng(text_arg value) &&;
+        opt_wrapper &about(text_arg value) &;
+        opt_wrapper &&about(text_arg value) &&;
+        // fall back to the environment variable `value` if not given
+        opt_wrapper &env(text_arg value) &;
+        opt_wrapper &&env(text_arg value) &&;
+        opt_wrapper &argname(text_arg value) &;
+        opt_wrapper &&argname(text_arg value) &&;
+        opt_wrapper &allow_hyphen() &;
+        opt_wrapper &&allow_hyphen() &&;
+        // split each value at `value` into several elements
+        opt_wrapper &delimiter(char value) &
+            requires(!std::same_as<OptT, const char *>);
+        opt_wrapper &&delimiter(char value) &&
+            requires(!std::same_as<OptT, const char *>);
+
+      private:
+        std::string_view get_argname() const override;
+        bool get_allow_hyphen() const override;
+        std::errc set(
+            std::ptrdiff_t offset, std::string_view value = {}) const override;
+        void assign(std::ptrdiff_t to, std::ptrdiff_t from) const override;
+        void save(std::ptrdiff_t offset, std::string &out) const override;
+        bool load(std::ptrdiff_t offset, std::string_view &in) const override;
+        std::string_view value_type() const override;
+        std::span<const std::string_view> choices() const override;
+        bool need_argument() const override;
+
+        std::reference_wrapper<inplace_vector<OptT, N>> _optref;
+        bool _allow_hyphen;
+        char _delimiter;
+        text _argname;
+    };
+
+    template <typename FnT>
+    class opt_wrapper<sink<FnT>> : public opt_base {
+      public:
+        opt_wrapper(FnT fn);
+        opt_wrapper(const opt_wrapper &) = default;
+        opt_wrapper(opt_wrapper &&other);
+        ~opt_wrapper() = default;
+        opt_wrapper &operator=(const opt_wrapper &) = default;
+        opt_wrapper &operator=(opt_wrapper &&other);
+
+        opt_wrapper &about(text_arg value) &;
+        opt_wrapper &&about(text_arg value) &&;
+        opt_wrapper &argname(text_arg value) &;
+        opt_wrapper &&argname(text_arg value) &&;
+
+      private:
+        std::string_view get_argname() const override;
+        std::errc set(
+            std::ptrdiff_t offset, std::string_view value = {}) const override;
+        bool need_argument() const override;
+
+        FnT _fn;
+        text _argname;
     };
 
     class anyopt {
@@ -444,61 +1747,131 @@ namespace _detail {
         const size_t opttype;
 
         inline char shrt() const;
-        inline const std::string &lng() const;
-        inline const std::string &about() const;
-        inline const std::string &argname() const;
+        inline std::string_view lng() const;
+        inline std::string_view about() const;
+        inline std::string_view env() const;
+        inline std::string_view argname() const;
         inline bool required() const;
         inline bool allow_hyphen() const;
         inline std::string def() const;
-        inline std::errc set(const char *value = nullptr);
-        inline bool already_set() const;
+        inline std::errc set(
+            std::ptrdiff_t offset, std::string_view value = {}) const;
+        inline void assign(std::ptrdiff_t to, std::ptrdiff_t from) const;
+        inline void save(std::ptrdiff_t offset, std::string &out) const;
+        inline bool load(std::ptrdiff_t offset, std::string_view &in) const;
+        inline std::string_view value_type() const;
+        inline std::span<const std::string_view> choices() const;
+        inline bool deferred() const;
+        inline std::errc set_many(
+            std::ptrdiff_t offset, std::span<const std::string_view> values,
+            size_t &failed) const;
+        // whether it can only be set once in an argument list
+        inline bool single() const;
         inline bool need_argument() const;
+        inline auto command(
+            std::ptrdiff_t offset, std::string_view name,
+            token_stream &tokens) const -> std::expected<bool, error>;
+        inline auto command_list() const
+            -> vector<std::pair<std::string_view, string>>;
+        inline auto command_names() const -> vector<std::string_view>;
+        inline void report_command(
+            std::span<const std::string> path, std::string_view program_name,
+            const error &err) const;
+        inline bool complete_command(
+            std::span<const char *const> words, string &out) const;
 
       private:
-        std::unique_ptr<opt_base> _origin;
+        unique_ptr<opt_base> _origin;
     };
 
-    const std::string &opt_base::get_argname() const {
-        static const std::string empty;
-        return empty;
-    }
+    char opt_base::get_shrt() const { return _shrt; }
+
+    std::string_view opt_base::get_lng() const { return _lng.view(); }
 
-    opt_base::opt_base() : _shrt{'\0'}, _lng{}, _about{}, _set_flag{false} {}
+    std::string_view opt_base::get_about() const { return _about.view(); }
 
-    opt_base::opt_base(opt_base &&other) :
+    std::string_view opt_base::get_env() const { return _env.view(); }
+
+#ifdef GREET_DEFINITIONS
+    GREET_INLINE std::string_view opt_base::get_argname() const { return {}; }
+
+    GREET_INLINE opt_base::opt_base() : _shrt{'\0'}, _lng{}, _about{}, _env{} {}
+
+    GREET_INLINE opt_base::opt_base(opt_base &&other) :
         _shrt{other._shrt},
         _lng(std::move(other._lng)),
         _about(std::move(other._about)),
-        _set_flag(other._set_flag) {
+        _env(std::move(other._env)) {
         other._shrt = '\0';
-        other._set_flag = false;
     }
 
-    opt_base &opt_base::operator=(opt_base &&other) {
+    GREET_INLINE opt_base &opt_base::operator=(opt_base &&other) {
         _shrt = other._shrt;
         other._shrt = '\0';
         _lng = std::move(other._lng);
         _about = std::move(other._about);
-        _set_flag = other._set_flag;
-        other._set_flag = false;
+        _env = std::move(other._env);
         return *this;
     }
 
-    char opt_base::get_shrt() const { return _shrt; }
+    GREET_INLINE bool opt_base::get_required() const { return false; }
+
+    GREET_INLINE bool opt_base::get_allow_hyphen() const { return false; }
+
+    GREET_INLINE std::string opt_base::get_def() const { return {}; }
+
+    GREET_INLINE void opt_base::assign(std::ptrdiff_t, std::ptrdiff_t) const {}
+
+    GREET_INLINE void opt_base::save(std::ptrdiff_t, std::string &) const {}
+
+    GREET_INLINE bool opt_base::load(std::ptrdiff_t, std::string_view &) const {
+        return true;
+    }
+
+    GREET_INLINE std::string_view opt_base::value_type() const { return {}; }
 
-    const std::string &opt_base::get_lng() const { return _lng; }
+    GREET_INLINE std::span<const std::string_view> opt_base::choices() const {
+        return {};
+    }
+
+    GREET_INLINE bool opt_base::get_deferred() const { return false; }
+
+    GREET_INLINE std::errc opt_base::set_many(
+        std::ptrdiff_t offset, std::span<const std::string_view> values,
+        size_t &failed) const {
+        for (failed = 0; failed < values.size(); ++failed) {
+            std::errc ec = set(offset, values[failed]);
+            if (ec != std::errc{}) return ec;
+        }
+        return {};
+    }
 
-    const std::string &opt_base::get_about() const { return _about; }
+    GREET_INLINE bool opt_base::need_argument() const { return false; }
 
-    bool opt_base::already_set() const { return _set_flag; }
+    GREET_INLINE auto opt_base::command(
+        std::ptrdiff_t, std::string_view, token_stream &) const
+        -> std::expected<bool, error> {
+        return false;
+    }
 
-    bool opt_base::get_required() const { return false; }
+    GREET_INLINE auto opt_base::command_list() const
+        -> vector<std::pair<std::string_view, string>> {
+        return {};
+    }
 
-    bool opt_base::get_allow_hyphen() const { return false; }
+    GREET_INLINE auto opt_base::command_names() const
+        -> vector<std::string_view> {
+        return {};
+    }
 
-    std::string opt_base::get_def() const { return {}; }
+    GREET_INLINE void opt_base::report_command(
+        std::span<const std::string>, std::string_view, const error &) const {}
 
-    bool opt_base::need_argument() const { return false; }
+    GREET_INLINE bool opt_base::complete_command(
+        std::span<const char *const>, string &) const {
+        return false;
+    }
+#endif
 
     template <option OptT>
     opt_wrapper<OptT>::opt_wrapper(OptT &optref) :
@@ -539,26 +1912,38 @@ namespace _detail {
     }
 
     template <option OptT>
-    opt_wrapper<OptT> &opt_wrapper<OptT>::lng(const std::string &value) & {
-        _lng = value;
+    opt_wrapper<OptT> &opt_wrapper<OptT>::lng(text_arg value) & {
+        _lng.assign(value);
         return *this;
     }
 
     template <option OptT>
-    opt_wrapper<OptT> &&opt_wrapper<OptT>::lng(const std::string &value) && {
-        _lng = value;
+    opt_wrapper<OptT> &&opt_wrapper<OptT>::lng(text_arg value) && {
+        _lng.assign(value);
         return std::move(*this);
     }
 
     template <option OptT>
-    opt_wrapper<OptT> &opt_wrapper<OptT>::about(const std::string &value) & {
-        _about = value;
+    opt_wrapper<OptT> &opt_wrapper<OptT>::about(text_arg value) & {
+        _about.assign(value);
         return *this;
     }
 
     template <option OptT>
-    opt_wrapper<OptT> &&opt_wrapper<OptT>::about(const std::string &value) && {
-        _about = value;
+    opt_wrapper<OptT> &&opt_wrapper<OptT>::about(text_arg value) && {
+        _about.assign(value);
+        return std::move(*this);
+    }
+
+    template <option OptT>
+    opt_wrapper<OptT> &opt_wrapper<OptT>::env(text_arg value) & {
+        _env.assign(value);
+        return *this;
+    }
+
+    template <option OptT>
+    opt_wrapper<OptT> &&opt_wrapper<OptT>::env(text_arg value) && {
+        _env.assign(value);
         return std::move(*this);
     }
 
@@ -587,15 +1972,15 @@ namespace _detail {
     }
 
     template <option OptT>
-    opt_wrapper<OptT> &opt_wrapper<OptT>::argname(const std::string &value) & {
-        _argname = value;
+    opt_wrapper<OptT> &opt_wrapper<OptT>::argname(text_arg value) & {
+        _argname.assign(value);
         return *this;
     }
 
     template <option OptT>
     opt_wrapper<OptT> &&opt_wrapper<OptT>::argname(
-        const std::string &value) && {
-        _argname = value;
+        text_arg value) && {
+        _argname.assign(value);
         return std::move(*this);
     }
 
@@ -618,8 +2003,8 @@ namespace _detail {
     }
 
     template <option OptT>
-    const std::string &opt_wrapper<OptT>::get_argname() const {
-        return _argname;
+    std::string_view opt_wrapper<OptT>::get_argname() const {
+        return _argname.view();
     }
 
     template <option OptT>
@@ -638,12 +2023,11 @@ namespace _detail {
     }
 
     template <option OptT>
-    std::errc opt_wrapper<OptT>::set(const char *value) {
-        std::expected<OptT, std::errc> expt =
-            string_converter<OptT>::from_str(value);
+    std::errc opt_wrapper<OptT>::set(
+        std::ptrdiff_t offset, std::string_view value) const {
+        std::expected<OptT, std::errc> expt = from_str<OptT>(value);
         if (expt) {
-            _optref.get() = std::move(expt.value());
-            _set_flag = true;
+            rebase(_optref.get(), offset) = std::move(expt.value());
         } else {
             return expt.error();
         }
@@ -651,121 +2035,242 @@ namespace _detail {
         return {};
     }
 
+    template <option OptT>
+    void opt_wrapper<OptT>::assign(
+        std::ptrdiff_t to, std::ptrdiff_t from) const {
+        rebase(_optref.get(), to) = rebase(_optref.get(), from);
+    }
+
+    template <option OptT>
+    void opt_wrapper<OptT>::save(
+        std::ptrdiff_t offset, std::string &out) const {
+        save_value(rebase(_optref.get(), offset), out);
+    }
+
+    template <option OptT>
+    bool opt_wrapper<OptT>::load(
+        std::ptrdiff_t offset, std::string_view &in) const {
+        return load_value(rebase(_optref.get(), offset), in);
+    }
+
+    template <option OptT>
+    std::string_view opt_wrapper<OptT>::value_type() const {
+        return type_name<OptT>();
+    }
+
+    template <option OptT>
+    std::span<const std::string_view> opt_wrapper<OptT>::choices() const {
+        return choice_names<OptT>();
+    }
+
     template <option OptT>
     bool opt_wrapper<OptT>::need_argument() const {
         return true;
     }
 
-    opt_wrapper<bool>::opt_wrapper(bool &optref) :
+#ifdef GREET_DEFINITIONS
+    GREET_INLINE opt_wrapper<bool>::opt_wrapper(bool &optref) :
         opt_base{}, _optref(optref) {}
 
-    opt_wrapper<bool>::opt_wrapper(opt_wrapper &&other) :
+    GREET_INLINE opt_wrapper<bool>::opt_wrapper(opt_wrapper &&other) :
         opt_base{std::move(other)}, _optref(other._optref) {}
 
-    opt_wrapper<bool> &opt_wrapper<bool>::operator=(opt_wrapper &&other) {
+    GREET_INLINE opt_wrapper<bool> &opt_wrapper<bool>::operator=(
+        opt_wrapper &&other) {
         opt_base::operator=(std::move(other));
         _optref = other._optref;
         return *this;
     }
 
-    opt_wrapper<bool> &opt_wrapper<bool>::shrt(char value) & {
+    GREET_INLINE opt_wrapper<bool> &opt_wrapper<bool>::shrt(char value) & {
         _shrt = value;
         return *this;
     }
 
-    opt_wrapper<bool> &&opt_wrapper<bool>::shrt(char value) && {
+    GREET_INLINE opt_wrapper<bool> &&opt_wrapper<bool>::shrt(char value) && {
         _shrt = value;
         return std::move(*this);
     }
 
-    opt_wrapper<bool> &opt_wrapper<bool>::lng(const std::string &value) & {
-        _lng = value;
+    GREET_INLINE opt_wrapper<bool> &opt_wrapper<bool>::lng(text_arg value) & {
+        _lng.assign(value);
         return *this;
     }
 
-    opt_wrapper<bool> &&opt_wrapper<bool>::lng(const std::string &value) && {
-        _lng = value;
+    GREET_INLINE opt_wrapper<bool> &&opt_wrapper<bool>::lng(text_arg value) && {
+        _lng.assign(value);
         return std::move(*this);
     }
 
-    opt_wrapper<bool> &opt_wrapper<bool>::about(const std::string &value) & {
-        _about = value;
+    GREET_INLINE opt_wrapper<bool> &opt_wrapper<bool>::about(text_arg value) & {
+        _about.assign(value);
         return *this;
     }
 
-    opt_wrapper<bool> &&opt_wrapper<bool>::about(const std::string &value) && {
-        _about = value;
+    GREET_INLINE opt_wrapper<bool> &&opt_wrapper<bool>::about(
+        text_arg value) && {
+        _about.assign(value);
+        return std::move(*this);
+    }
+
+    GREET_INLINE opt_wrapper<bool> &opt_wrapper<bool>::env(text_arg value) & {
+        _env.assign(value);
+        return *this;
+    }
+
+    GREET_INLINE opt_wrapper<bool> &&opt_wrapper<bool>::env(text_arg value) && {
+        _env.assign(value);
         return std::move(*this);
     }
 
-    std::errc opt_wrapper<bool>::set(const char *value) {
+    GREET_INLINE std::errc opt_wrapper<bool>::set(
+        std::ptrdiff_t offset, std::string_view value) const {
         (void)value;
-        _optref.get() = true;
-        _set_flag = true;
+        rebase(_optref.get(), offset) = true;
         return {};
     }
 
-    opt_wrapper<counter>::opt_wrapper(counter &optref) :
+    GREET_INLINE void opt_wrapper<bool>::assign(
+        std::ptrdiff_t to, std::ptrdiff_t from) const {
+        rebase(_optref.get(), to) = rebase(_optref.get(), from);
+    }
+
+    GREET_INLINE void opt_wrapper<bool>::save(
+        std::ptrdiff_t offset, std::string &out) const {
+        save_value(rebase(_optref.get(), offset), out);
+    }
+
+    GREET_INLINE bool opt_wrapper<bool>::load(
+        std::ptrdiff_t offset, std::string_view &in) const {
+        return load_value(rebase(_optref.get(), offset), in);
+    }
+
+    GREET_INLINE std::string_view opt_wrapper<bool>::value_type() const {
+        return type_name<bool>();
+    }
+
+    GREET_INLINE opt_wrapper<counter>::opt_wrapper(counter &optref) :
         opt_base{}, _optref(optref) {}
 
-    opt_wrapper<counter>::opt_wrapper(opt_wrapper &&other) :
+    GREET_INLINE opt_wrapper<counter>::opt_wrapper(opt_wrapper &&other) :
         opt_base{std::move(other)}, _optref(other._optref) {}
 
-    opt_wrapper<counter> &opt_wrapper<counter>::operator=(opt_wrapper &&other) {
+    GREET_INLINE opt_wrapper<counter> &opt_wrapper<counter>::operator=(
+        opt_wrapper &&other) {
         opt_base::operator=(std::move(other));
         _optref = other._optref;
         return *this;
     }
 
-    opt_wrapper<counter> &opt_wrapper<counter>::shrt(char value) & {
+    GREET_INLINE opt_wrapper<counter> &opt_wrapper<counter>::shrt(
+        char value) & {
         _shrt = value;
         return *this;
     }
 
-    opt_wrapper<counter> &&opt_wrapper<counter>::shrt(char value) && {
+    GREET_INLINE opt_wrapper<counter> &&opt_wrapper<counter>::shrt(
+        char value) && {
         _shrt = value;
         return std::move(*this);
     }
 
-    opt_wrapper<counter> &opt_wrapper<counter>::lng(
-        const std::string &value) & {
-        _lng = value;
+    GREET_INLINE opt_wrapper<counter> &opt_wrapper<counter>::lng(
+        text_arg value) & {
+        _lng.assign(value);
         return *this;
     }
 
-    opt_wrapper<counter> &&opt_wrapper<counter>::lng(
-        const std::string &value) && {
-        _lng = value;
+    GREET_INLINE opt_wrapper<counter> &&opt_wrapper<counter>::lng(
+        text_arg value) && {
+        _lng.assign(value);
         return std::move(*this);
     }
 
-    opt_wrapper<counter> &opt_wrapper<counter>::about(
-        const std::string &value) & {
-        _about = value;
+    GREET_INLINE opt_wrapper<counter> &opt_wrapper<counter>::about(
+        text_arg value) & {
+        _about.assign(value);
         return *this;
     }
 
-    opt_wrapper<counter> &&opt_wrapper<counter>::about(
-        const std::string &value) && {
-        _about = value;
+    GREET_INLINE opt_wrapper<counter> &&opt_wrapper<counter>::about(
+        text_arg value) && {
+        _about.assign(value);
         return std::move(*this);
     }
 
-    std::errc opt_wrapper<counter>::set(const char *value) {
+    GREET_INLINE opt_wrapper<counter> &opt_wrapper<counter>::env(
+        text_arg value) & {
+        _env.assign(value);
+        return *this;
+    }
+
+    GREET_INLINE opt_wrapper<counter> &&opt_wrapper<counter>::env(
+        text_arg value) && {
+        _env.assign(value);
+        return std::move(*this);
+    }
+
+    GREET_INLINE std::errc opt_wrapper<counter>::set(
+        std::ptrdiff_t offset, std::string_view value) const {
+        (void)value;
+        ++rebase(_optref.get(), offset);
+        return {};
+    }
+
+    GREET_INLINE void opt_wrapper<counter>::assign(
+        std::ptrdiff_t to, std::ptrdiff_t from) const {
+        rebase(_optref.get(), to) = rebase(_optref.get(), from);
+    }
+
+    GREET_INLINE void opt_wrapper<counter>::save(
+        std::ptrdiff_t offset, std::string &out) const {
+        save_raw<uint64_t>(rebase(_optref.get(), offset), out);
+    }
+
+    GREET_INLINE bool opt_wrapper<counter>::load(
+        std::ptrdiff_t offset, std::string_view &in) const {
+        uint64_t times;
+        if (!load_raw(times, in) || !std::in_range<size_t>(times)) return false;
+        rebase(_optref.get(), offset)._counter = static_cast<size_t>(times);
+        return true;
+    }
+
+    GREET_INLINE std::string_view opt_wrapper<counter>::value_type() const {
+        return type_name<counter>();
+    }
+
+    GREET_INLINE opt_wrapper<builtin_flag>::opt_wrapper(
+        char shrt, std::string_view lng, std::string_view about) :
+        opt_base{} {
+        _shrt = shrt;
+        _lng.assign(lng);
+        _about.assign(about);
+    }
+
+    GREET_INLINE std::errc opt_wrapper<builtin_flag>::set(
+        std::ptrdiff_t offset, std::string_view value) const {
+        (void)offset;
         (void)value;
-        ++_optref.get();
         return {};
     }
+#endif
 
     template <option OptT>
     opt_wrapper<std::vector<OptT>>::opt_wrapper(std::vector<OptT> &optref) :
-        opt_base{}, _optref(optref), _allow_hyphen(false), _argname{} {}
+        opt_base{},
+        _optref(optref),
+        _allow_hyphen(false),
+        _delimiter('\0'),
+        _argname{},
+        _bulk(nullptr) {}
 
     template <option OptT>
     opt_wrapper<std::vector<OptT>>::opt_wrapper(opt_wrapper &&other) :
         opt_base(std::move(other)), _optref(other._optref) {
         _allow_hyphen = other._allow_hyphen;
+        _delimiter = other._delimiter;
         _argname = std::move(other._argname);
+        _bulk = other._bulk;
     }
 
     template <option OptT>
@@ -774,7 +2279,9 @@ namespace _detail {
         opt_base::operator=(std::move(other));
         _optref = other._optref;
         _allow_hyphen = other._allow_hyphen;
+        _delimiter = other._delimiter;
         _argname = std::move(other._argname);
+        _bulk = other._bulk;
         return *this;
     }
 
@@ -794,43 +2301,57 @@ namespace _detail {
 
     template <option OptT>
     opt_wrapper<std::vector<OptT>> &opt_wrapper<std::vector<OptT>>::lng(
-        const std::string &value) & {
-        _lng = value;
+        text_arg value) & {
+        _lng.assign(value);
         return *this;
     }
 
     template <option OptT>
     opt_wrapper<std::vector<OptT>> &&opt_wrapper<std::vector<OptT>>::lng(
-        const std::string &value) && {
-        _lng = value;
+        text_arg value) && {
+        _lng.assign(value);
         return std::move(*this);
     }
 
     template <option OptT>
     opt_wrapper<std::vector<OptT>> &opt_wrapper<std::vector<OptT>>::about(
-        const std::string &value) & {
-        _about = value;
+        text_arg value) & {
+        _about.assign(value);
         return *this;
     }
 
     template <option OptT>
     opt_wrapper<std::vector<OptT>> &&opt_wrapper<std::vector<OptT>>::about(
-        const std::string &value) && {
-        _about = value;
+        text_arg value) && {
+        _about.assign(value);
+        return std::move(*this);
+    }
+
+    template <option OptT>
+    opt_wrapper<std::vector<OptT>> &opt_wrapper<std::vector<OptT>>::env(
+        text_arg value) & {
+        _env.assign(value);
+        return *this;
+    }
+
+    template <option OptT>
+    opt_wrapper<std::vector<OptT>> &&opt_wrapper<std::vector<OptT>>::env(
+        text_arg value) && {
+        _env.assign(value);
         return std::move(*this);
     }
 
     template <option OptT>
     opt_wrapper<std::vector<OptT>> &opt_wrapper<std::vector<OptT>>::argname(
-        const std::string &value) & {
-        _argname = value;
+        text_arg value) & {
+        _argname.assign(value);
         return *this;
     }
 
     template <option OptT>
     opt_wrapper<std::vector<OptT>> &&opt_wrapper<std::vector<OptT>>::argname(
-        const std::string &value) && {
-        _argname = value;
+        text_arg value) && {
+        _argname.assign(value);
         return std::move(*this);
     }
 
@@ -849,542 +2370,4458 @@ namespace _detail {
     }
 
     template <option OptT>
-    const std::string &opt_wrapper<std::vector<OptT>>::get_argname() const {
-        return _argname;
+    opt_wrapper<std::vector<OptT>> &
+    opt_wrapper<std::vector<OptT>>::delimiter(char value) &
+        requires(!std::same_as<OptT, const char *>)
+    {
+        _delimiter = value;
+        return *this;
     }
 
     template <option OptT>
-    bool opt_wrapper<std::vector<OptT>>::get_allow_hyphen() const {
-        return _allow_hyphen;
+    opt_wrapper<std::vector<OptT>> &&
+    opt_wrapper<std::vector<OptT>>::delimiter(char value) &&
+        requires(!std::same_as<OptT, const char *>)
+    {
+        _delimiter = value;
+        return std::move(*this);
     }
 
     template <option OptT>
-    std::errc opt_wrapper<std::vector<OptT>>::set(const char *value) {
-        std::expected<OptT, std::errc> expt =
-            string_converter<OptT>::from_str(value);
+    opt_wrapper<std::vector<OptT>> &
+    opt_wrapper<std::vector<OptT>>::deferred() & {
+        _bulk = &convert_bulk<OptT, sequenced>;
+        return *this;
+    }
 
-        if (expt)
-            _optref.get().emplace_back(std::move(expt.value()));
-        else
-            return expt.error();
+    template <option OptT>
+    opt_wrapper<std::vector<OptT>> &&
+    opt_wrapper<std::vector<OptT>>::deferred() && {
+        _bulk = &convert_bulk<OptT, sequenced>;
+        return std::move(*this);
+    }
 
-        return {};
+    template <option OptT>
+    template <typename PolicyT>
+    opt_wrapper<std::vector<OptT>> &
+    opt_wrapper<std::vector<OptT>>::deferred(PolicyT) & {
+        _bulk = &convert_bulk<OptT, PolicyT>;
+        return *this;
     }
 
     template <option OptT>
-    bool opt_wrapper<std::vector<OptT>>::need_argument() const {
-        return true;
+    template <typename PolicyT>
+    opt_wrapper<std::vector<OptT>> &&
+    opt_wrapper<std::vector<OptT>>::deferred(PolicyT) && {
+        _bulk = &convert_bulk<OptT, PolicyT>;
+        return std::move(*this);
     }
 
-    template <typename OptT>
-    anyopt::anyopt(const opt_wrapper<OptT> &origin) :
-        opttype(opt_type_v<OptT>), _origin(new opt_wrapper<OptT>(origin)) {}
+    template <option OptT>
+    std::string_view opt_wrapper<std::vector<OptT>>::get_argname() const {
+        return _argname.view();
+    }
+
+    template <option OptT>
+    bool opt_wrapper<std::vector<OptT>>::get_allow_hyphen() const {
+        return _allow_hyphen;
+    }
+
+    template <option OptT>
+    std::errc opt_wrapper<std::vector<OptT>>::set(
+        std::ptrdiff_t offset, std::string_view value) const {
+        if (_delimiter)
+            return append_split(
+                rebase(_optref.get(), offset), value, _delimiter);
+
+        std::expected<OptT, std::errc> expt = from_str<OptT>(value);
+
+        if (expt)
+            rebase(_optref.get(), offset).emplace_back(std::move(expt.value()));
+        else
+            return expt.error();
+
+        return {};
+    }
+
+    template <option OptT>
+    void opt_wrapper<std::vector<OptT>>::assign(
+        std::ptrdiff_t to, std::ptrdiff_t from) const {
+        rebase(_optref.get(), to) = rebase(_optref.get(), from);
+    }
+
+    template <option OptT>
+    void opt_wrapper<std::vector<OptT>>::save(
+        std::ptrdiff_t offset, std::string &out) const {
+        save_values(rebase(_optref.get(), offset), out);
+    }
+
+    template <option OptT>
+    bool opt_wrapper<std::vector<OptT>>::load(
+        std::ptrdiff_t offset, std::string_view &in) const {
+        return load_values(rebase(_optref.get(), offset), in);
+    }
+
+    template <option OptT>
+    std::string_view opt_wrapper<std::vector<OptT>>::value_type() const {
+        return type_name<std::vector<OptT>>();
+    }
+
+    template <option OptT>
+    auto opt_wrapper<std::vector<OptT>>::choices() const
+        -> std::span<const std::string_view> {
+        return choice_names<OptT>();
+    }
+
+    template <option OptT>
+    bool opt_wrapper<std::vector<OptT>>::get_deferred() const {
+        return _bulk;
+    }
+
+    template <option OptT>
+    std::errc opt_wrapper<std::vector<OptT>>::set_many(
+        std::ptrdiff_t offset, std::span<const std::string_view> values,
+        size_t &failed) const {
+        if (!_bulk) return opt_base::set_many(offset, values, failed);
+        return _bulk(rebase(_optref.get(), offset), values, _delimiter, failed);
+    }
+
+    template <option OptT>
+    bool opt_wrapper<std::vector<OptT>>::need_argument() const {
+        return true;
+    }
+
+    template <option OptT, size_t N>
+    opt_wrapper<inplace_vector<OptT, N>>::opt_wrapper(
+        inplace_vector<OptT, N> &optref) :
+        opt_base{},
+        _optref(optref),
+        _allow_hyphen(false),
+        _delimiter('\0'),
+        _argname{} {}
+
+    template <option OptT, size_t N>
+    opt_wrapper<inplace_vector<OptT, N>>::opt_wrapper(opt_wrapper &&other) :
+        opt_base(std::move(other)), _optref(other._optref) {
+        _allow_hyphen = other._allow_hyphen;
+        _delimiter = other._delimiter;
+        _argname = std::move(other._argname);
+    }
+
+    template <option OptT, size_t N>
+    auto opt_wrapper<inplace_vector<OptT, N>>::operator=(opt_wrapper &&other)
+        -> opt_wrapper & {
+        opt_base::operator=(std::move(other));
+        _optref = other._optref;
+        _allow_hyphen = other._allow_hyphen;
+        _delimiter = other._delimiter;
+        _argname = std::move(other._argname);
+        return *this;
+    }
+
+    template <option OptT, size_t N>
+    auto opt_wrapper<inplace_vector<OptT, N>>::shrt(char value) &
+        -> opt_wrapper & {
+        _shrt = value;
+        return *this;
+    }
+
+    template <option OptT, size_t N>
+    auto opt_wrapper<inplace_vector<OptT, N>>::shrt(char value) &&
+        -> opt_wrapper && {
+        _shrt = value;
+        return std::move(*this);
+    }
+
+    template <option OptT, size_t N>
+    auto opt_wrapper<inplace_vector<OptT, N>>::lng(text_arg value) &
+        -> opt_wrapper & {
+        _lng.assign(value);
+        return *this;
+    }
+
+    template <option OptT, size_t N>
+    auto opt_wrapper<inplace_vector<OptT, N>>::lng(text_arg value) &&
+        -> opt_wrapper && {
+        _lng.assign(value);
+        return std::move(*this);
+    }
+
+    template <option OptT, size_t N>
+    auto opt_wrapper<inplace_vector<OptT, N>>::about(text_arg value) &
+        -> opt_wrapper & {
+        _about.assign(value);
+        return *this;
+    }
+
+    template <option OptT, size_t N>
+    auto opt_wrapper<inplace_vector<OptT, N>>::about(text_arg value) &&
+        -> opt_wrapper && {
+        _about.assign(value);
+        return std::move(*this);
+    }
+
+    template <option OptT, size_t N>
+    auto opt_wrapper<inplace_vector<OptT, N>>::env(text_arg value) &
+        -> opt_wrapper & {
+        _env.assign(value);
+        return *this;
+    }
+
+    template <option OptT, size_t N>
+    auto opt_wrapper<inplace_vector<OptT, N>>::env(text_arg value) &&
+        -> opt_wrapper && {
+        _env.assign(value);
+        return std::move(*this);
+    }
+
+    template <option OptT, size_t N>
+    auto opt_wrapper<inplace_vector<OptT, N>>::argname(text_arg value) &
+        -> opt_wrapper & {
+        _argname.assign(value);
+        return *this;
+    }
+
+    template <option OptT, size_t N>
+    auto opt_wrapper<inplace_vector<OptT, N>>::argname(text_arg value) &&
+        -> opt_wrapper && {
+        _argname.assign(value);
+        return std::move(*this);
+    }
+
+    template <option OptT, size_t N>
+    auto opt_wrapper<inplace_vector<OptT, N>>::allow_hyphen() &
+        -> opt_wrapper & {
+        _allow_hyphen = true;
+        return *this;
+    }
+
+    template <option OptT, size_t N>
+    auto opt_wrapper<inplace_vector<OptT, N>>::allow_hyphen() &&
+        -> opt_wrapper && {
+        _allow_hyphen = true;
+        return std::move(*this);
+    }
+
+    template <option OptT, size_t N>
+    auto opt_wrapper<inplace_vector<OptT, N>>::delimiter(char value) &
+        -> opt_wrapper &
+        requires(!std::same_as<OptT, const char *>)
+    {
+        _delimiter = value;
+        return *this;
+    }
+
+    template <option OptT, size_t N>
+    auto opt_wrapper<inplace_vector<OptT, N>>::delimiter(char value) &&
+        -> opt_wrapper &&
+        requires(!std::same_as<OptT, const char *>)
+    {
+        _delimiter = value;
+        return std::move(*this);
+    }
+
+    template <option OptT, size_t N>
+    std::string_view opt_wrapper<inplace_vector<OptT, N>>::get_argname() const {
+        return _argname.view();
+    }
+
+    template <option OptT, size_t N>
+    bool opt_wrapper<inplace_vector<OptT, N>>::get_allow_hyphen() const {
+        return _allow_hyphen;
+    }
+
+    template <option OptT, size_t N>
+    std::errc opt_wrapper<inplace_vector<OptT, N>>::set(
+        std::ptrdiff_t offset, std::string_view value) const {
+        if (_delimiter)
+            return append_split(
+                rebase(_optref.get(), offset), value, _delimiter);
+        return append_value(rebase(_optref.get(), offset), value);
+    }
+
+    template <option OptT, size_t N>
+    void opt_wrapper<inplace_vector<OptT, N>>::assign(
+        std::ptrdiff_t to, std::ptrdiff_t from) const {
+        rebase(_optref.get(), to) = rebase(_optref.get(), from);
+    }
+
+    template <option OptT, size_t N>
+    void opt_wrapper<inplace_vector<OptT, N>>::save(
+        std::ptrdiff_t offset, std::string &out) const {
+        save_values(rebase(_optref.get(), offset), out);
+    }
+
+    template <option OptT, size_t N>
+    bool opt_wrapper<inplace_vector<OptT, N>>::load(
+        std::ptrdiff_t offset, std::string_view &in) const {
+        return load_values(rebase(_optref.get(), offset), in);
+    }
+
+    template <option OptT, size_t N>
+    std::string_view opt_wrapper<inplace_vector<OptT, N>>::value_type() const {
+        return type_name<inplace_vector<OptT, N>>();
+    }
+
+    template <option OptT, size_t N>
+    auto opt_wrapper<inplace_vector<OptT, N>>::choices() const
+        -> std::span<const std::string_view> {
+        return choice_names<OptT>();
+    }
+
+    template <option OptT, size_t N>
+    bool opt_wrapper<inplace_vector<OptT, N>>::need_argument() const {
+        return true;
+    }
+
+    template <typename FnT>
+    opt_wrapper<sink<FnT>>::opt_wrapper(FnT fn) :
+        opt_base{}, _fn(std::move(fn)), _argname{} {}
+
+    template <typename FnT>
+    opt_wrapper<sink<FnT>>::opt_wrapper(opt_wrapper &&other) :
+        opt_base{std::move(other)},
+        _fn(std::move(other._fn)),
+        _argname(std::move(other._argname)) {}
+
+    template <typename FnT>
+    opt_wrapper<sink<FnT>> &opt_wrapper<sink<FnT>>::operator=(
+        opt_wrapper &&other) {
+        opt_base::operator=(std::move(other));
+        _fn = std::move(other._fn);
+        _argname = std::move(other._argname);
+        return *this;
+    }
+
+    template <typename FnT>
+    opt_wrapper<sink<FnT>> &opt_wrapper<sink<FnT>>::about(
+        text_arg value) & {
+        _about.assign(value);
+        return *this;
+    }
+
+    template <typename FnT>
+    opt_wrapper<sink<FnT>> &&opt_wrapper<sink<FnT>>::about(
+        text_arg value) && {
+        _about.assign(value);
+        return std::move(*this);
+    }
+
+    template <typename FnT>
+    opt_wrapper<sink<FnT>> &opt_wrapper<sink<FnT>>::argname(
+        text_arg value) & {
+        _argname.assign(value);
+        return *this;
+    }
+
+    template <typename FnT>
+    opt_wrapper<sink<FnT>> &&opt_wrapper<sink<FnT>>::argname(
+        text_arg value) && {
+        _argname.assign(value);
+        return std::move(*this);
+    }
+
+    template <typename FnT>
+    std::string_view opt_wrapper<sink<FnT>>::get_argname() const {
+        return _argname.view();
+    }
+
+    template <typename FnT>
+    std::errc opt_wrapper<sink<FnT>>::set(
+        std::ptrdiff_t offset, std::string_view value) const {
+        (void)offset;
+        if constexpr (std::same_as<
+                          std::invoke_result_t<const FnT &, std::string_view>,
+                          std::errc>)
+            return _fn(value);
+        else
+            _fn(value);
+        return {};
+    }
+
+    template <typename FnT>
+    bool opt_wrapper<sink<FnT>>::need_argument() const {
+        return true;
+    }
+
+    template <typename OptT>
+    anyopt::anyopt(const opt_wrapper<OptT> &origin) :
+        opttype(opt_type_v<OptT>),
+        _origin(allocate_unique<opt_wrapper<OptT>>(origin)) {}
+
+    template <typename OptT>
+    anyopt::anyopt(opt_wrapper<OptT> &&origin) :
+        opttype(opt_type_v<OptT>),
+        _origin(allocate_unique<opt_wrapper<OptT>>(std::move(origin))) {}
+
+    char anyopt::shrt() const { return _origin.get()->get_shrt(); }
+
+    std::string_view anyopt::lng() const { return _origin.get()->get_lng(); }
+
+    std::string_view anyopt::about() const {
+        return _origin.get()->get_about();
+    }
+
+    std::string_view anyopt::env() const { return _origin.get()->get_env(); }
+
+    std::string_view anyopt::argname() const {
+        return _origin.get()->get_argname();
+    }
+
+    bool anyopt::required() const { return _origin.get()->get_required(); }
+
+    bool anyopt::allow_hyphen() const {
+        return _origin.get()->get_allow_hyphen();
+    }
+
+    std::string anyopt::def() const { return _origin.get()->get_def(); }
+
+    std::errc anyopt::set(
+        std::ptrdiff_t offset, std::string_view value) const {
+        return _origin.get()->set(offset, value);
+    }
+
+    void anyopt::assign(std::ptrdiff_t to, std::ptrdiff_t from) const {
+        _origin.get()->assign(to, from);
+    }
+
+    void anyopt::save(std::ptrdiff_t offset, std::string &out) const {
+        _origin.get()->save(offset, out);
+    }
+
+    bool anyopt::load(std::ptrdiff_t offset, std::string_view &in) const {
+        return _origin.get()->load(offset, in);
+    }
+
+    std::string_view anyopt::value_type() const {
+        return _origin.get()->value_type();
+    }
+
+    std::span<const std::string_view> anyopt::choices() const {
+        return _origin.get()->choices();
+    }
+
+    bool anyopt::deferred() const { return _origin.get()->get_deferred(); }
+
+    std::errc anyopt::set_many(
+        std::ptrdiff_t offset, std::span<const std::string_view> values,
+        size_t &failed) const {
+        return _origin.get()->set_many(offset, values, failed);
+    }
+
+    bool anyopt::single() const {
+        return opttype == NORMAL || opttype == BOOLEAN || opttype == COMMAND;
+    }
+
+    inline bool anyopt::need_argument() const {
+        return _origin.get()->need_argument();
+    }
+
+    auto anyopt::command(
+        std::ptrdiff_t offset, std::string_view name,
+        token_stream &tokens) const -> std::expected<bool, error> {
+        return _origin.get()->command(offset, name, tokens);
+    }
+
+    auto anyopt::command_list() const
+        -> vector<std::pair<std::string_view, string>> {
+        return _origin.get()->command_list();
+    }
+
+    auto anyopt::command_names() const -> vector<std::string_view> {
+        return _origin.get()->command_names();
+    }
+
+    void anyopt::report_command(
+        std::span<const std::string> path, std::string_view program_name,
+        const error &err) const {
+        _origin.get()->report_command(path, program_name, err);
+    }
+
+    bool anyopt::complete_command(
+        std::span<const char *const> words, string &out) const {
+        return _origin.get()->complete_command(words, out);
+    }
+
+    template <typename OptRefT>
+    string get_argname(const OptRefT &optref) {
+        if (!optref.argname().empty())
+            return string(optref.argname());
+        else if (!optref.lng().empty())
+            return uppercase(string(optref.lng()));
+        else
+            return "VALUE";
+    }
+
+    // Append the long flags of `sorted` starting with `prefix`, one per line.
+    template <typename FlagsT>
+    void append_long_flags(
+        const FlagsT &sorted, std::string_view prefix, string &out) {
+        auto first = std::lower_bound(
+            sorted.begin(),
+            sorted.end(),
+            prefix,
+            [](const auto &item, std::string_view value) {
+                return item.first < value;
+            });
+        for (; first != sorted.end() && first->first.starts_with(prefix);
+             ++first) {
+            out += "--";
+            out += first->first;
+            out += '\n';
+        }
+    }
+
+    // Levenshtein distance of `lhs` and `rhs` if it is at most `bound`,
+    // otherwise `bound + 1`. Only the band of `2 * bound + 1` cells around
+    // the diagonal is computed, and it stops once a row exceeds `bound`.
+    inline size_t bounded_distance(
+        std::string_view lhs, std::string_view rhs, size_t bound,
+        vector<size_t> &rows) {
+        if (lhs.size() > rhs.size()) std::swap(lhs, rhs);
+        const size_t far = bound + 1;
+        if (rhs.size() - lhs.size() > bound) return far;
+
+        const size_t width = rhs.size() + 1;
+        rows.assign(2 * width, far);
+        size_t *prev = rows.data();
+        size_t *cur = prev + width;
+        for (size_t j = 0; j <= std::min(rhs.size(), bound); ++j) prev[j] = j;
+
+        for (size_t i = 1; i <= lhs.size(); ++i) {
+            size_t lo = i > bound ? i - bound : 1;
+            size_t hi = std::min(rhs.size(), i + bound);
+            cur[lo - 1] = lo == 1 ? std::min(i, far) : far;
+            size_t best = cur[lo - 1];
+            for (size_t j = lo; j <= hi; ++j) {
+                size_t cost = lhs[i - 1] != rhs[j - 1];
+                cur[j] = std::min(
+                    {prev[j - 1] + cost, prev[j] + 1, cur[j - 1] + 1, far});
+                best = std::min(best, cur[j]);
+            }
+            if (hi < rhs.size()) cur[hi + 1] = far;
+            if (best >= far) return far;
+            std::swap(prev, cur);
+        }
+        return prev[rhs.size()];
+    }
+
+    // Up to 3 long flags of `sorted` close to `name`, flags which `name` is a
+    // prefix of come first.
+    template <typename FlagsT>
+    std::vector<std::string> similar_flags(
+        const FlagsT &sorted, std::string_view name) {
+        constexpr size_t limit = 3;
+        std::vector<std::string> result;
+        auto first = std::lower_bound(
+            sorted.begin(),
+            sorted.end(),
+            name,
+            [](const auto &item, std::string_view value) {
+                return item.first < value;
+            });
+        for (; first != sorted.end() && first->first.starts_with(name) &&
+               result.size() < limit;
+             ++first)
+            result.emplace_back(std::format("--{}", first->first));
+        if (!result.empty()) return result;
+
+        // roughly one typo every three characters
+        const size_t bound = std::clamp<size_t>((name.size() + 2) / 3, 1, 3);
+        vector<size_t> rows;
+        std::vector<std::pair<size_t, std::string_view>> close;
+        for (const auto &item : sorted) {
+            size_t distance = bounded_distance(name, item.first, bound, rows);
+            if (distance <= bound) close.emplace_back(distance, item.first);
+        }
+        std::stable_sort(
+            close.begin(), close.end(), [](const auto &lhs, const auto &rhs) {
+                return lhs.first < rhs.first;
+            });
+        for (size_t i = 0; i < std::min(close.size(), limit); ++i)
+            result.emplace_back(std::format("--{}", close[i].second));
+        return result;
+    }
+
+    // Which options of a `greet::meta` the current parse has set, one bit per
+    // option. It belongs to a single parse so the schema can stay immutable.
+    class set_flags {
+      public:
+        explicit set_flags(size_t size);
+        set_flags(const set_flags &) = delete;
+        set_flags(set_flags &&) = delete;
+
+        bool test(size_t pos) const;
+        void set(size_t pos);
+
+      private:
+        uint64_t *_words();
+        const uint64_t *_words() const;
+
+        // enough for 256 options without allocating
+        std::array<uint64_t, 4> _inline{};
+        vector<uint64_t> _heap;
+    };
+
+    inline set_flags::set_flags(size_t size) {
+        if (size > _inline.size() * 64) _heap.resize((size + 63) / 64);
+    }
+
+    inline bool set_flags::test(size_t pos) const {
+        return _words()[pos / 64] & (uint64_t{1} << (pos % 64));
+    }
+
+    inline void set_flags::set(size_t pos) {
+        _words()[pos / 64] |= uint64_t{1} << (pos % 64);
+    }
+
+    inline uint64_t *set_flags::_words() {
+        return _heap.empty() ? _inline.data() : _heap.data();
+    }
+
+    inline const uint64_t *set_flags::_words() const {
+        return _heap.empty() ? _inline.data() : _heap.data();
+    }
+}  // namespace _detail
+
+class meta {
+  public:
+    template <typename... OptionTs>
+    meta(OptionTs &&...options);
+    meta(const meta &) = delete;
+    meta(meta &&) = delete;
+
+    auto opts() const -> const _detail::vector<_detail::anyopt> &;
+    auto ignored_args() const
+        -> std::optional<std::reference_wrapper<ignored>>;
+    auto ignored_view_args() const
+        -> std::optional<std::reference_wrapper<ignored_view>>;
+    auto required_opts() const -> const _detail::vector<
+        std::reference_wrapper<const _detail::anyopt>> &;
+    auto query(char flag) const
+        -> std::optional<std::reference_wrapper<const _detail::anyopt>>;
+    auto query(std::string_view flag) const
+        -> std::optional<std::reference_wrapper<const _detail::anyopt>>;
+    // options without flags, in the order they are declared
+    auto positionals() const
+        -> const _detail::vector<const _detail::anyopt *> &;
+    // the subcommand option, if any
+    auto commands() const -> const _detail::anyopt *;
+    // short flags of the options which take no argument
+    auto switches() const -> const _detail::char_set &;
+    // options with an environment variable, sorted by the hash of its name
+    auto env_vars() const -> const _detail::vector<
+        std::pair<uint64_t, const _detail::anyopt *>> &;
+    // position of `optref` in `opts()`, which indexes the set flags of a parse
+    inline size_t index_of(const _detail::anyopt &optref) const;
+    inline bool help(const _detail::set_flags &flags) const;
+    inline bool version(const _detail::set_flags &flags) const;
+    // the flags which `partial` can be completed to, one per line
+    inline void complete(std::string_view partial, _detail::string &out) const;
+    // long flags similar to the unknown long flag `flag`
+    inline std::vector<std::string> suggest(std::string_view flag) const;
+
+  private:
+    template <typename OptionT>
+    inline void _unpack_opt(OptionT &&option);
+
+    _detail::vector<_detail::anyopt> _opts;
+    std::optional<std::reference_wrapper<ignored>> _ignored_args;
+    std::optional<std::reference_wrapper<ignored_view>> _ignored_view_args;
+    _detail::vector<std::reference_wrapper<const _detail::anyopt>>
+        _required_opts;
+    // indexed by `flag - '!'`, covers all printable characters
+    std::array<const _detail::anyopt *, '~' - '!' + 1> _short_flags;
+    _detail::char_set _switches;
+    // sorted by the long flag without leading "--", views into `_opts`
+    _detail::vector<std::pair<std::string_view, const _detail::anyopt *>>
+        _long_flags;
+    _detail::vector<const _detail::anyopt *> _positionals;
+    _detail::vector<std::pair<uint64_t, const _detail::anyopt *>> _env_vars;
+    const _detail::anyopt *_commands;
+    bool _abbreviations;
+};
+
+namespace _detail {
+    // What the help needs to know about an option, only built when printing.
+    struct opt_info {
+        size_t opttype;
+        char shrt;
+        string lng;
+        string about;
+        string argname;
+        bool required;
+        bool need_argument;
+        string def;
+        // the environment variable to fall back to
+        string env;
+        // the only values it accepts, empty if any
+        std::span<const std::string_view> choices;
+        // names and descriptions of subcommands
+        vector<std::pair<std::string_view, string>> commands;
+    };
+
+    // options of a `greet::static_meta` have no environment variables
+    template <typename OptRefT>
+    std::string_view env_of(const OptRefT &) {
+        return {};
+    }
+
+    inline std::string_view env_of(const anyopt &optref) {
+        return optref.env();
+    }
+
+    template <typename OptRefT>
+    opt_info describe(const OptRefT &optref) {
+        if constexpr (std::same_as<OptRefT, anyopt>)
+            if (optref.opttype == COMMAND)
+                return {
+                    .opttype = COMMAND,
+                    .shrt = '\0',
+                    .lng = {},
+                    .about = {},
+                    .argname = {},
+                    .required = optref.required(),
+                    .need_argument = false,
+                    .def = {},
+                    .env = {},
+                    .choices = {},
+                    .commands = optref.command_list(),
+                };
+        return {
+            .opttype = optref.opttype,
+            .shrt = optref.shrt(),
+            .lng = string(optref.lng()),
+            .about = string(optref.about()),
+            .argname = get_argname(optref),
+            .required = optref.required(),
+            .need_argument = optref.need_argument(),
+            .def = optref.opttype == NORMAL && !optref.required()
+                       ? string(optref.def())
+                       : string{},
+            .env = string(env_of(optref)),
+            .choices = optref.choices(),
+            .commands = {},
+        };
+    }
+
+    /// Renders the help text of a meta, the option table is rendered once
+    /// and reused by every help message and error report.
+    class print_helper {
+      public:
+        explicit print_helper(vector<opt_info> &&opts);
+        print_helper(const print_helper &) = delete;
+        print_helper(print_helper &&) = delete;
+
+        string usage(std::string_view program_name) const;
+        string help(
+            std::string_view description, std::string_view program_name) const;
+        string error_message(
+            const error &err, std::string_view program_name) const;
+        [[noreturn]] static void internal_error(const std::string &msg);
+        template <typename InfoT>
+        [[noreturn]] void report(
+            InfoT &info, std::string_view program_name, const error &err) const;
+
+      private:
+        void append_usage(
+            string &out, std::string_view program_name) const;
+
+        string _required;
+        string _arguments;
+        string _commands;
+        string _options;
+    };
+
+    // `<NAME>` if required, otherwise `[NAME]`, and `...` if it takes many
+    inline void append_positional(string &out, const opt_info &info) {
+        out += info.required ? '<' : '[';
+        out += info.argname;
+        out += info.required ? '>' : ']';
+        if (info.opttype == VECTOR) out += "...";
+    }
+
+    inline void append_env(string &out, const opt_info &info) {
+        if (info.env.empty()) return;
+        out += " [env: ";
+        out += info.env;
+        out += ']';
+    }
+
+    inline void append_choices(string &out, const opt_info &info) {
+        if (info.choices.empty()) return;
+        out += " [possible values: ";
+        for (size_t i = 0; i < info.choices.size(); ++i) {
+            if (i) out += ", ";
+            out += info.choices[i];
+        }
+        out += ']';
+    }
+
+    /// Write the whole buffer with a single call and flush it.
+    inline void write_all(std::FILE *stream, std::string_view text) {
+        std::fwrite(text.data(), 1, text.size(), stream);
+        std::fflush(stream);
+    }
+
+#ifdef GREET_DEFINITIONS
+    GREET_INLINE print_helper::print_helper(vector<opt_info> &&opts) {
+        auto positional = [](const opt_info &info) {
+            return info.opttype != COMMAND && info.shrt == '\0' &&
+                   info.lng.empty();
+        };
+        // positionals and the subcommand follow the flags in the usage
+        string positionals;
+        string command;
+        size_t fixed_width = 0;
+        for (const auto &info : opts) {
+            if (info.opttype == COMMAND) {
+                command = info.required ? " <COMMAND>" : " [COMMAND]";
+                for (const auto &[name, about] : info.commands)
+                    fixed_width = std::max(fixed_width, name.size() + 4);
+                continue;
+            }
+            if (positional(info)) {
+                positionals += ' ';
+                append_positional(positionals, info);
+                fixed_width = std::max(
+                    fixed_width,
+                    info.argname.size() + (info.opttype == VECTOR ? 9 : 6));
+                continue;
+            }
+
+            size_t width = 8;
+            if (!info.lng.empty()) width += 2 + info.lng.size();
+            if (info.need_argument) width += 3 + info.argname.size();
+            fixed_width = std::max(fixed_width, width);
+
+            if (!info.required) continue;
+            if (info.lng.empty())
+                std::format_to(
+                    std::back_inserter(_required),
+                    " -{} <{}>",
+                    info.shrt,
+                    info.argname);
+            else
+                std::format_to(
+                    std::back_inserter(_required),
+                    " --{} <{}>",
+                    info.lng,
+                    info.argname);
+        }
+        _required += positionals;
+        _required += command;
+
+        for (const auto &info : opts) {
+            if (!positional(info)) continue;
+            if (_arguments.empty()) _arguments = "Arguments:\n";
+            size_t start = _arguments.size();
+            _arguments += "  ";
+            append_positional(_arguments, info);
+            _arguments.resize(start + fixed_width, ' ');
+            _arguments += info.about;
+            append_choices(_arguments, info);
+            append_env(_arguments, info);
+            if (info.opttype == NORMAL && !info.required) {
+                _arguments += " [default: ";
+                _arguments += info.def;
+                _arguments += ']';
+            }
+            _arguments += '\n';
+        }
+        if (!_arguments.empty()) _arguments += '\n';
+
+        for (const auto &info : opts) {
+            if (info.opttype != COMMAND) continue;
+            _commands = "Commands:\n";
+            for (const auto &[name, about] : info.commands) {
+                size_t start = _commands.size();
+                _commands += "  ";
+                _commands += name;
+                _commands.resize(start + fixed_width, ' ');
+                _commands += about;
+                _commands += '\n';
+            }
+            _commands += '\n';
+        }
+
+        _options = "Options:\n";
+        for (const auto &info : opts) {
+            if (info.opttype == COMMAND || positional(info)) continue;
+            size_t start = _options.size();
+            _options += "  ";
+            if (info.shrt == '\0') {
+                _options += "   ";
+            } else {
+                _options += '-';
+                _options += info.shrt;
+                if (!info.lng.empty()) _options += ',';
+            }
+            if (!info.lng.empty()) {
+                _options += " --";
+                _options += info.lng;
+            }
+            if (info.need_argument) {
+                _options += " <";
+                _options += info.argname;
+                _options += '>';
+            }
+            _options.resize(
+                std::max(_options.size(), start + fixed_width), ' ');
+            _options += info.about;
+            append_choices(_options, info);
+            append_env(_options, info);
+            if (info.opttype == NORMAL) {
+                if (info.required) {
+                    _options += " [REQUIRED]";
+                } else {
+                    _options += " [default: ";
+                    _options += info.def;
+                    _options += ']';
+                }
+            }
+            _options += '\n';
+        }
+    }
+#endif
+
+#ifdef GREET_DEFINITIONS
+    GREET_INLINE void print_helper::append_usage(
+        string &out, std::string_view program_name) const {
+        out += "Usage: ";
+        out += program_name;
+        out += " [OPTIONS]";
+        out += _required;
+        out += '\n';
+    }
+
+    GREET_INLINE string print_helper::usage(
+        std::string_view program_name) const {
+        string out;
+        append_usage(out, program_name);
+        return out;
+    }
+
+    GREET_INLINE string print_helper::help(
+        std::string_view description, std::string_view program_name) const {
+        string out;
+        out.reserve(
+            description.size() + program_name.size() + _required.size() +
+            _arguments.size() + _commands.size() + _options.size() + 24);
+        out += description;
+        out += "\n\n";
+        append_usage(out, program_name);
+        out += '\n';
+        out += _arguments;
+        out += _commands;
+        out += _options;
+        return out;
+    }
+
+    GREET_INLINE string print_helper::error_message(
+        const error &err, std::string_view program_name) const {
+        string out = "error: ";
+        out += err.message();
+        out += "\n\n";
+        append_usage(out, program_name);
+        out += "\nFor more information, try '--help'.\n";
+        return out;
+    }
+
+    [[noreturn]] GREET_INLINE void print_helper::internal_error(
+        const std::string &msg) {
+        write_all(stderr, "[internal error]: " + msg + '\n');
+        std::exit(1);
+    }
+#endif
+
+    template <typename InfoT>
+    [[noreturn]] void print_helper::report(
+        InfoT &info, std::string_view program_name, const error &err) const {
+        switch (err.kind) {
+            case error_kind::display_help:
+                write_all(stdout, help(info.description(), program_name));
+                std::exit(0);
+            case error_kind::display_version:
+                write_all(stdout, std::string(info.version()) + '\n');
+                std::exit(0);
+            default:
+                break;
+        }
+
+        write_all(stderr, error_message(err, program_name));
+        std::exit(2);
+    }
+}  // namespace _detail
+
+template <typename OptT>
+auto opt(OptT &optref) {
+    if constexpr (
+        std::is_same_v<std::decay_t<OptT>, ignored> ||
+        std::is_same_v<std::decay_t<OptT>, ignored_view>)
+        return std::ref(optref);
+    else
+        return _detail::opt_wrapper<OptT>(optref);
+};
+
+/// A positional argument taking all of the remaining values, each value is
+/// passed to `fn` as soon as it is parsed instead of being stored.
+///
+/// `fn` may return a `std::errc` to reject the value. It is not bound to the
+/// argument group, so a `greet::parser` calls the same `fn` for every parse.
+template <typename FnT>
+    requires std::invocable<const FnT &, std::string_view> &&
+             std::copy_constructible<FnT>
+auto opt_sink(FnT fn) {
+    return _detail::opt_wrapper<_detail::sink<FnT>>(std::move(fn));
+}
+
+inline counter::counter() : _counter{0} {}
+
+inline counter::counter(counter &&other) {
+    _counter = other._counter;
+    other._counter = 0;
+}
+
+inline counter &counter::operator=(counter &&other) {
+    _counter = other._counter;
+    other._counter = 0;
+    return *this;
+};
+
+inline counter &counter::operator++() {
+    ++_counter;
+    return *this;
+}
+
+inline counter counter::operator++(int) {
+    counter prev = *this;
+    ++_counter;
+    return prev;
+}
+
+inline counter::operator size_t() { return _counter; }
+
+#ifdef GREET_DEFINITIONS
+GREET_INLINE std::string error::message() const {
+    if (!location.empty()) {
+        error inner = *this;
+        inner.location.clear();
+        return std::format("{}: {}", location, inner.message());
+    }
+    switch (kind) {
+        case error_kind::unexpected_argument: {
+            std::string msg =
+                std::format("unexpected argument '{}' found", value);
+            if (suggestions.size() == 1)
+                msg += std::format(
+                    "\n\n  tip: a similar argument exists: '{}'",
+                    suggestions.front());
+            else if (!suggestions.empty()) {
+                msg += "\n\n  tip: some similar arguments exist:";
+                for (const auto &item : suggestions)
+                    msg += std::format(" '{}'", item);
+            }
+            return msg;
+        }
+        case error_kind::missing_value:
+            return std::format(
+                "a value is required for '{} <{}>' but none was supplied",
+                flag,
+                argname);
+        case error_kind::unexpected_value:
+            return std::format(
+                "unexpected value '{}' for '{}' found; no more were expected",
+                value,
+                flag);
+        case error_kind::invalid_value:
+            if (flag.empty())
+                return std::format(
+                    "invalid value '{}' for '<{}>': {}",
+                    value,
+                    argname,
+                    std::make_error_code(ec).message());
+            return std::format(
+                "invalid value '{}' for '{} <{}>': {}",
+                value,
+                flag,
+                argname,
+                std::make_error_code(ec).message());
+        case error_kind::used_multiple:
+            if (argname.empty())
+                return std::format(
+                    "the argument '{}' cannot be used multiple times", flag);
+            else
+                return std::format(
+                    "the argument '{} <{}>' cannot be used multiple times",
+                    flag,
+                    argname);
+        case error_kind::too_many_values:
+            if (flag.empty())
+                return std::format(
+                    "too many values for '<{}>'; '{}' exceeds its capacity",
+                    argname,
+                    value);
+            return std::format(
+                "too many values for '{} <{}>'; '{}' exceeds its capacity",
+                flag,
+                argname,
+                value);
+        case error_kind::missing_options: {
+            std::string msg =
+                "the following required arguments were not provided:";
+            for (const auto &item : missing) msg += std::format("\n  {}", item);
+            return msg;
+        }
+        case error_kind::recursive_response_file:
+            return std::format("response file '{}' includes itself", value);
+        case error_kind::display_help:
+            return "help information was requested";
+        case error_kind::display_version:
+            return "version information was requested";
+        default:
+            std::unreachable();
+    }
+}
+#endif
+
+template <typename... OptionTs>
+meta::meta(OptionTs &&...options) :
+    _opts{},
+    _ignored_args(std::nullopt),
+    _ignored_view_args(std::nullopt),
+    _required_opts{},
+    _short_flags{},
+    _switches{},
+    _long_flags{},
+    _positionals{},
+    _env_vars{},
+    _commands(nullptr),
+    _abbreviations(false) {
+    constexpr size_t ignored_opt_nums =
+        _detail::type_count<std::reference_wrapper<ignored>, OptionTs...> +
+        _detail::type_count<std::reference_wrapper<ignored_view>, OptionTs...>;
+    static_assert(
+        ignored_opt_nums <= 1,
+        "can only provide 0 or 1 `greet::ignored` or `greet::ignored_view` "
+        "option!");
+    constexpr size_t setting_nums =
+        _detail::type_count<abbreviations_t, std::decay_t<OptionTs>...>;
+
+    _opts.reserve(sizeof...(OptionTs) + 2 - ignored_opt_nums - setting_nums);
+    (_unpack_opt(std::forward<OptionTs>(options)), ...);
+
+    // `help()` and `version()` expect them to be the last two options
+    _opts.emplace_back(
+        _detail::anyopt(_detail::opt_wrapper<_detail::builtin_flag>(
+            'h', "help", "Print help")));
+    _opts.emplace_back(
+        _detail::anyopt(_detail::opt_wrapper<_detail::builtin_flag>(
+            'V', "version", "Print version")));
+
+    _long_flags.reserve(_opts.size());
+
+    for (auto &optref : _opts) {
+        if (optref.opttype == _detail::COMMAND) {
+            if (_commands)
+                _detail::print_helper::internal_error(
+                    "can only provide 0 or 1 `greet::subcommands` option.");
+            _commands = &optref;
+            if (optref.required())
+                _required_opts.emplace_back(std::ref(optref));
+            continue;
+        }
+
+        if (!optref.env().empty())
+            _env_vars.emplace_back(_detail::hash_name(optref.env()), &optref);
+
+        if (optref.shrt() == '\0' && optref.lng().empty()) {
+            if (optref.opttype != _detail::NORMAL &&
+                optref.opttype != _detail::VECTOR)
+                _detail::print_helper::internal_error(
+                    "there is a BOOLEAN or COUNTER option that specifies "
+                    "neither short nor long flags.");
+            if (!_positionals.empty() &&
+                _positionals.back()->opttype == _detail::VECTOR)
+                _detail::print_helper::internal_error(
+                    "only the last positional argument can take multiple "
+                    "values.");
+            _positionals.emplace_back(&optref);
+            if (optref.required())
+                _required_opts.emplace_back(std::ref(optref));
+            continue;
+        }
+
+        if (optref.shrt() != '\0') {
+            if (optref.shrt() < '!' || optref.shrt() > '~')
+                _detail::print_helper::internal_error(
+                    "the short flag must be a printable character.");
+            if (optref.shrt() == '-')
+                _detail::print_helper::internal_error(
+                    "the short flag cannot be '-'.");
+
+            auto &slot = _short_flags[optref.shrt() - '!'];
+            if (slot)
+                _detail::print_helper::internal_error(std::format(
+                    "the flag '-{}' is already be used.", optref.shrt()));
+            slot = &optref;
+            if (!optref.need_argument()) _switches.set(optref.shrt());
+        }
+        if (!optref.lng().empty())
+            _long_flags.emplace_back(optref.lng(), &optref);
+
+        if (optref.required()) _required_opts.emplace_back(std::ref(optref));
+    };
+
+    std::sort(
+        _long_flags.begin(),
+        _long_flags.end(),
+        [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+    auto duplicated = std::adjacent_find(
+        _long_flags.begin(),
+        _long_flags.end(),
+        [](const auto &lhs, const auto &rhs) {
+            return lhs.first == rhs.first;
+        });
+    if (duplicated != _long_flags.end())
+        _detail::print_helper::internal_error(std::format(
+            "the flag '--{}' is already be used.", duplicated->first));
+
+    std::sort(_env_vars.begin(), _env_vars.end());
+    for (size_t i = 1; i < _env_vars.size(); ++i)
+        for (size_t j = i; j-- > 0 && _env_vars[j].first == _env_vars[i].first;)
+            if (_env_vars[j].second->env() == _env_vars[i].second->env())
+                _detail::print_helper::internal_error(std::format(
+                    "the environment variable '{}' is already be used.",
+                    _env_vars[i].second->env()));
+}
+
+inline auto meta::opts() const -> const _detail::vector<_detail::anyopt> & {
+    return _opts;
+}
+
+inline auto meta::ignored_args() const
+    -> std::optional<std::reference_wrapper<ignored>> {
+    return _ignored_args;
+}
+
+inline auto meta::ignored_view_args() const
+    -> std::optional<std::reference_wrapper<ignored_view>> {
+    return _ignored_view_args;
+}
+
+inline auto meta::required_opts() const -> const _detail::vector<
+    std::reference_wrapper<const _detail::anyopt>> & {
+    return _required_opts;
+}
+
+inline auto meta::positionals() const
+    -> const _detail::vector<const _detail::anyopt *> & {
+    return _positionals;
+}
+
+inline auto meta::commands() const -> const _detail::anyopt * {
+    return _commands;
+}
+
+inline auto meta::switches() const -> const _detail::char_set & {
+    return _switches;
+}
+
+inline auto meta::env_vars() const -> const _detail::vector<
+    std::pair<uint64_t, const _detail::anyopt *>> & {
+    return _env_vars;
+}
+
+inline auto meta::query(char flag) const
+    -> std::optional<std::reference_wrapper<const _detail::anyopt>> {
+    if (flag < '!' || flag > '~' || !_short_flags[flag - '!'])
+        return std::nullopt;
+    return std::ref(*_short_flags[flag - '!']);
+};
+
+inline auto meta::query(std::string_view flag) const
+    -> std::optional<std::reference_wrapper<const _detail::anyopt>> {
+    auto found = std::lower_bound(
+        _long_flags.begin(),
+        _long_flags.end(),
+        flag,
+        [](const auto &item, std::string_view value) {
+            return item.first < value;
+        });
+    if (found != _long_flags.end() && found->first == flag)
+        return std::ref(*found->second);
+    // an abbreviation must be the prefix of exactly one flag
+    if (!_abbreviations || found == _long_flags.end() ||
+        !found->first.starts_with(flag))
+        return std::nullopt;
+    auto next = std::next(found);
+    if (next != _long_flags.end() && next->first.starts_with(flag))
+        return std::nullopt;
+    return std::ref(*found->second);
+};
+
+inline size_t meta::index_of(const _detail::anyopt &optref) const {
+    return static_cast<size_t>(&optref - _opts.data());
+}
+
+// `-h` and `-V` are the last two options
+inline bool meta::help(const _detail::set_flags &flags) const {
+    return flags.test(_opts.size() - 2);
+}
+
+inline bool meta::version(const _detail::set_flags &flags) const {
+    return flags.test(_opts.size() - 1);
+}
+
+inline std::vector<std::string> meta::suggest(std::string_view flag) const {
+    return _detail::similar_flags(_long_flags, flag);
+}
+
+inline void meta::complete(
+    std::string_view partial, _detail::string &out) const {
+    if (partial == "-")
+        for (size_t i = 0; i < _short_flags.size(); ++i)
+            if (_short_flags[i]) {
+                out += '-';
+                out += static_cast<char>('!' + i);
+                out += '\n';
+            }
+    if (partial == "-" || partial.starts_with("--"))
+        _detail::append_long_flags(
+            _long_flags, partial.substr(std::min<size_t>(partial.size(), 2)),
+            out);
+}
+
+template <typename OptionT>
+inline void meta::_unpack_opt(OptionT &&option) {
+    if constexpr (std::is_same_v<
+                      std::decay_t<OptionT>,
+                      std::reference_wrapper<ignored>>)
+        _ignored_args = option;
+    else if constexpr (std::is_same_v<
+                           std::decay_t<OptionT>,
+                           std::reference_wrapper<ignored_view>>)
+        _ignored_view_args = option;
+    else if constexpr (std::is_same_v<std::decay_t<OptionT>, abbreviations_t>)
+        _abbreviations = true;
+    else
+        _opts.emplace_back(_detail::anyopt(std::forward<OptionT>(option)));
+}
+
+namespace _detail {
+    // The parse loop reaches the options of a meta through these functions,
+    // `greet::static_meta` provides the same set.
+
+    inline const anyopt *lookup(const meta &m, char flag) {
+        auto result = m.query(flag);
+        return result ? &result.value().get() : nullptr;
+    }
+
+    inline const anyopt *lookup(const meta &m, std::string_view flag) {
+        auto result = m.query(flag);
+        return result ? &result.value().get() : nullptr;
+    }
+
+    inline const char_set &switches_of(const meta &m) { return m.switches(); }
+
+    // the state of a single parse, see `set_flags`
+    inline set_flags parse_state(const meta &m) {
+        return set_flags(m.opts().size());
+    }
+
+    inline size_t index_of(const meta &m, const anyopt *optref) {
+        return m.index_of(*optref);
+    }
+
+    // Identifies the layout of the values saved by `save_args()`.
+    inline uint64_t schema_hash(const meta &m) {
+        uint64_t hash = 0xcbf29ce484222325;
+        for (const anyopt &optref : m.opts()) {
+            char shrt = optref.shrt();
+            size_t opttype = optref.opttype;
+            hash_bytes(hash, std::string_view(&shrt, 1));
+            hash_bytes(hash, optref.lng());
+            hash_bytes(hash, std::string_view(
+                reinterpret_cast<const char *>(&opttype), sizeof(opttype)));
+            hash_bytes(hash, optref.value_type());
+            // the separator keeps adjacent fields apart
+            hash_bytes(hash, std::string_view("", 1));
+        }
+        hash_bytes(hash, m.ignored_args() ? "ignored" : "");
+        return hash;
+    }
+
+    // The values of the options of `m` in order, then the ignored arguments.
+    inline void save_args(
+        const meta &m, std::ptrdiff_t offset, std::string &out) {
+        for (const anyopt &optref : m.opts()) optref.save(offset, out);
+        if (auto ignored_args = m.ignored_args())
+            save_values<std::vector<std::string>>(
+                rebase(ignored_args.value().get(), offset), out);
+    }
+
+    inline bool load_args(
+        const meta &m, std::ptrdiff_t offset, std::string_view &in) {
+        for (const anyopt &optref : m.opts())
+            if (!optref.load(offset, in)) return false;
+        if (auto ignored_args = m.ignored_args())
+            return load_values<std::vector<std::string>>(
+                rebase(ignored_args.value().get(), offset), in);
+        return true;
+    }
+
+    inline void store_ignored(
+        const meta &m, std::ptrdiff_t offset,
+        std::span<const char *const> tail) {
+        if (auto view_args = m.ignored_view_args()) {
+            rebase(view_args.value().get(), offset) =
+                ignored_view(tail.data(), tail.size());
+        } else if (auto ignored_args = m.ignored_args()) {
+            auto &target = rebase(ignored_args.value().get(), offset);
+            target.reserve(tail.size());
+            for (const char *arg : tail) target.emplace_back(arg);
+        }
+    }
+
+    inline std::vector<std::string> missing_opts(
+        const meta &m, const set_flags &flags) {
+        std::vector<std::string> missing{};
+        for (const auto &optref : m.required_opts())
+            if (!flags.test(m.index_of(optref.get()))) {
+                if (optref.get().opttype == COMMAND)
+                    missing.emplace_back("<COMMAND>");
+                else if (
+                    optref.get().shrt() == '\0' && optref.get().lng().empty())
+                    missing.emplace_back(
+                        std::format("<{}>", get_argname(optref.get())));
+                else if (optref.get().lng().empty())
+                    missing.emplace_back(std::format(
+                        "-{} <{}>",
+                        optref.get().shrt(),
+                        get_argname(optref.get())));
+                else
+                    missing.emplace_back(std::format(
+                        "--{} <{}>",
+                        optref.get().lng(),
+                        get_argname(optref.get())));
+            }
+        return missing;
+    }
+
+    inline std::span<const anyopt *const> positionals_of(const meta &m) {
+        return m.positionals();
+    }
+
+    inline const anyopt *commands_of(const meta &m) { return m.commands(); }
+
+    inline vector<opt_info> describe_opts(const meta &m) {
+        vector<opt_info> infos;
+        infos.reserve(m.opts().size());
+        for (const auto &optref : m.opts())
+            infos.emplace_back(describe(optref));
+        return infos;
+    }
+
+    template <size_t N>
+    struct fixed_string {
+        char value[N];
+
+        constexpr fixed_string(const char (&str)[N]) {
+            std::copy_n(str, N, value);
+        }
+
+        constexpr std::string_view view() const { return {value, N - 1}; }
+    };
+
+    template <size_t N>
+    class bitmask {
+      public:
+        constexpr void set(size_t pos) {
+            _words[pos / 64] |= uint64_t{1} << (pos % 64);
+        }
+
+        constexpr bool test(size_t pos) const {
+            return _words[pos / 64] & (uint64_t{1} << (pos % 64));
+        }
+
+        constexpr void clear() { _words.fill(0); }
+
+      private:
+        std::array<uint64_t, (N + 63) / 64> _words{};
+    };
+
+    // An option of `greet::static_meta`, the flags and whether it is required
+    // are a part of its type.
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required = false>
+    class static_opt {
+      public:
+        static constexpr size_t opttype = opt_type_v<OptT>;
+        static constexpr char shrt_flag = Shrt;
+        static constexpr std::string_view lng_flag = Lng.view();
+        static constexpr bool required_flag = Required;
+        static constexpr bool need_argument_flag =
+            opttype == NORMAL || opttype == VECTOR;
+        // NORMAL and BOOLEAN options cannot be used multiple times
+        static constexpr bool single_flag =
+            opttype == NORMAL || opttype == BOOLEAN;
+        // pieces of a split value are not null terminated
+        static constexpr bool splittable = [] {
+            if constexpr (opttype == VECTOR)
+                return !std::same_as<typename OptT::value_type, const char *>;
+            else
+                return true;
+        }();
+
+        constexpr explicit static_opt(OptT &optref);
+        template <bool OtherRequired>
+        constexpr static_opt(
+            const static_opt<OptT, Shrt, Lng, OtherRequired> &other);
+
+        constexpr static_opt &about(std::string_view value) &;
+        constexpr static_opt &&about(std::string_view value) &&;
+        constexpr static_opt &argname(std::string_view value) &
+            requires need_argument_flag;
+        constexpr static_opt &&argname(std::string_view value) &&
+            requires need_argument_flag;
+        constexpr static_opt &allow_hyphen() &
+            requires need_argument_flag;
+        constexpr static_opt &&allow_hyphen() &&
+            requires need_argument_flag;
+        constexpr static_opt &delimiter(char value) &
+            requires(opttype == VECTOR) && splittable;
+        constexpr static_opt &&delimiter(char value) &&
+            requires(opttype == VECTOR) && splittable;
+        constexpr static_opt<OptT, Shrt, Lng, true> required() const
+            requires(opttype == NORMAL);
+        template <typename... DefT>
+        static_opt &def(DefT &&...value) &
+            requires(opttype == NORMAL) &&
+                    std::constructible_from<OptT, DefT...>;
+        template <typename... DefT>
+        static_opt &&def(DefT &&...value) &&
+            requires(opttype == NORMAL) &&
+                    std::constructible_from<OptT, DefT...>;
+
+        std::string_view get_about() const;
+        std::string_view get_argname() const;
+        bool get_allow_hyphen() const;
+        std::string get_def() const;
+        std::span<const std::string_view> get_choices() const;
+        std::errc set(std::ptrdiff_t offset, std::string_view value) const;
+
+      private:
+        template <typename, char, fixed_string, bool>
+        friend class static_opt;
+
+        OptT *_optref;
+        std::string_view _about;
+        std::string_view _argname;
+        bool _allow_hyphen;
+        char _delimiter;
+    };
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    constexpr static_opt<OptT, Shrt, Lng, Required>::static_opt(OptT &optref) :
+        _optref(&optref),
+        _about{},
+        _argname{},
+        _allow_hyphen{false},
+        _delimiter{'\0'} {}
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    template <bool OtherRequired>
+    constexpr static_opt<OptT, Shrt, Lng, Required>::static_opt(
+        const static_opt<OptT, Shrt, Lng, OtherRequired> &other) :
+        _optref(other._optref),
+        _about(other._about),
+        _argname(other._argname),
+        _allow_hyphen(other._allow_hyphen),
+        _delimiter(other._delimiter) {}
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    constexpr auto static_opt<OptT, Shrt, Lng, Required>::about(
+        std::string_view value) & -> static_opt & {
+        _about = value;
+        return *this;
+    }
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    constexpr auto static_opt<OptT, Shrt, Lng, Required>::about(
+        std::string_view value) && -> static_opt && {
+        _about = value;
+        return std::move(*this);
+    }
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    constexpr auto static_opt<OptT, Shrt, Lng, Required>::argname(
+        std::string_view value) & -> static_opt &
+        requires need_argument_flag
+    {
+        _argname = value;
+        return *this;
+    }
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    constexpr auto static_opt<OptT, Shrt, Lng, Required>::argname(
+        std::string_view value) && -> static_opt &&
+        requires need_argument_flag
+    {
+        _argname = value;
+        return std::move(*this);
+    }
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    constexpr auto static_opt<OptT, Shrt, Lng, Required>::allow_hyphen() &
+        -> static_opt &
+        requires need_argument_flag
+    {
+        _allow_hyphen = true;
+        return *this;
+    }
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    constexpr auto static_opt<OptT, Shrt, Lng, Required>::allow_hyphen() &&
+        -> static_opt &&
+        requires need_argument_flag
+    {
+        _allow_hyphen = true;
+        return std::move(*this);
+    }
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    constexpr auto static_opt<OptT, Shrt, Lng, Required>::delimiter(
+        char value) & -> static_opt &
+        requires(opttype == VECTOR) && splittable
+    {
+        _delimiter = value;
+        return *this;
+    }
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    constexpr auto static_opt<OptT, Shrt, Lng, Required>::delimiter(
+        char value) && -> static_opt &&
+        requires(opttype == VECTOR) && splittable
+    {
+        _delimiter = value;
+        return std::move(*this);
+    }
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    constexpr auto static_opt<OptT, Shrt, Lng, Required>::required() const
+        -> static_opt<OptT, Shrt, Lng, true>
+        requires(opttype == NORMAL)
+    {
+        return static_opt<OptT, Shrt, Lng, true>(*this);
+    }
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    template <typename... DefT>
+    auto static_opt<OptT, Shrt, Lng, Required>::def(DefT &&...value) &
+        -> static_opt &
+        requires(opttype == NORMAL) && std::constructible_from<OptT, DefT...>
+    {
+        *_optref = OptT(std::forward<DefT>(value)...);
+        return *this;
+    }
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    template <typename... DefT>
+    auto static_opt<OptT, Shrt, Lng, Required>::def(DefT &&...value) &&
+        -> static_opt &&
+        requires(opttype == NORMAL) && std::constructible_from<OptT, DefT...>
+    {
+        *_optref = OptT(std::forward<DefT>(value)...);
+        return std::move(*this);
+    }
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    std::string_view static_opt<OptT, Shrt, Lng, Required>::get_about() const {
+        return _about;
+    }
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    std::string_view static_opt<OptT, Shrt, Lng, Required>::get_argname()
+        const {
+        return _argname;
+    }
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    bool static_opt<OptT, Shrt, Lng, Required>::get_allow_hyphen() const {
+        return _allow_hyphen;
+    }
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    std::string static_opt<OptT, Shrt, Lng, Required>::get_def() const {
+        if constexpr (opttype == NORMAL)
+            return string_converter<OptT>::to_str(*_optref);
+        else
+            return {};
+    }
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    auto static_opt<OptT, Shrt, Lng, Required>::get_choices() const
+        -> std::span<const std::string_view> {
+        if constexpr (opttype == VECTOR)
+            return choice_names<typename OptT::value_type>();
+        else
+            return choice_names<OptT>();
+    }
+
+    template <typename OptT, char Shrt, fixed_string Lng, bool Required>
+    std::errc static_opt<OptT, Shrt, Lng, Required>::set(
+        std::ptrdiff_t offset, std::string_view value) const {
+        OptT &target = rebase(*_optref, offset);
+        if constexpr (opttype == NORMAL) {
+            std::expected<OptT, std::errc> expt = from_str<OptT>(value);
+            if (!expt) return expt.error();
+            target = std::move(expt.value());
+        } else if constexpr (opttype == BOOLEAN) {
+            target = true;
+        } else if constexpr (opttype == COUNTER) {
+            ++target;
+        } else {
+            if (_delimiter) return append_split(target, value, _delimiter);
+            return append_value(target, value);
+        }
+        return {};
+    }
+
+    // What `greet::static_meta` knows about each of its elements at compile
+    // time, `greet::ignored` and `greet::ignored_view` have no flags.
+    template <typename OptionT>
+    struct static_traits {
+        static constexpr char shrt = OptionT::shrt_flag;
+        static constexpr std::string_view lng = OptionT::lng_flag;
+        static constexpr size_t opttype = OptionT::opttype;
+        static constexpr bool required = OptionT::required_flag;
+        static constexpr bool need_argument = OptionT::need_argument_flag;
+        static constexpr bool single = OptionT::single_flag;
+        static constexpr bool ignored = false;
+    };
+
+    template <typename IgnoredT>
+        requires std::same_as<IgnoredT, std::reference_wrapper<ignored>> ||
+                 std::same_as<IgnoredT, std::reference_wrapper<ignored_view>>
+    struct static_traits<IgnoredT> {
+        static constexpr char shrt = '\0';
+        static constexpr std::string_view lng{};
+        static constexpr size_t opttype = NORMAL;
+        static constexpr bool required = false;
+        static constexpr bool need_argument = false;
+        static constexpr bool single = false;
+        static constexpr bool ignored = true;
+    };
+}  // namespace _detail
+
+/// A schema whose flags are known at compile time, built from
+/// `greet::opt<'s', "long">(member)` options.
+///
+/// Flags are dispatched through constant tables and the options are stored
+/// by value, so building it never allocates and parsing never makes a
+/// virtual call.
+template <typename... OptionTs>
+class static_meta {
+  public:
+    class handle;
+
+    constexpr static_meta(OptionTs... options);
+
+    // the options and the built-in `-h` and `-V` a parse has set
+    using state_type = _detail::bitmask<sizeof...(OptionTs) + 2>;
+
+    handle lookup(char flag) const;
+    handle lookup(std::string_view flag) const;
+    // short flags of the options which take no argument
+    const _detail::char_set &switches() const;
+    bool help(const state_type &flags) const;
+    bool version(const state_type &flags) const;
+    // the flags which `partial` can be completed to, one per line
+    void complete(std::string_view partial, _detail::string &out) const;
+    // long flags similar to the unknown long flag `flag`
+    std::vector<std::string> suggest(std::string_view flag) const;
+
+    void store_ignored(
+        std::ptrdiff_t offset, std::span<const char *const> tail) const;
+    std::vector<std::string> missing_opts(const state_type &flags) const;
+    _detail::vector<_detail::opt_info> describe_opts() const;
+
+  private:
+    // the built-in `-h` and `-V` follow the options
+    static constexpr size_t _help_index = sizeof...(OptionTs);
+    static constexpr size_t _version_index = _help_index + 1;
+    static constexpr size_t _size = _help_index + 2;
+
+    static constexpr std::array<char, _size> _shrts{
+        _detail::static_traits<OptionTs>::shrt..., 'h', 'V'};
+    static constexpr std::array<std::string_view, _size> _lngs{
+        _detail::static_traits<OptionTs>::lng..., "help", "version"};
+    static constexpr std::array<size_t, _size> _opttypes{
+        _detail::static_traits<OptionTs>::opttype...,
+        _detail::BOOLEAN,
+        _detail::BOOLEAN};
+    static constexpr std::array<bool, _size> _required{
+        _detail::static_traits<OptionTs>::required..., false, false};
+    static constexpr std::array<bool, _size> _need_argument{
+        _detail::static_traits<OptionTs>::need_argument..., false, false};
+    static constexpr std::array<bool, _size> _single{
+        _detail::static_traits<OptionTs>::single..., true, true};
+    static constexpr std::array<bool, _size> _ignored{
+        _detail::static_traits<OptionTs>::ignored..., false, false};
+
+    static constexpr auto _short_flags = [] {
+        // option index + 1, indexed by `flag - '!'`
+        std::array<size_t, '~' - '!' + 1> table{};
+        for (size_t i = 0; i < _size; ++i)
+            if (_shrts[i] >= '!' && _shrts[i] <= '~')
+                table[_shrts[i] - '!'] = i + 1;
+        return table;
+    }();
+
+    static constexpr auto _switches = [] {
+        _detail::char_set set;
+        for (size_t i = 0; i < _size; ++i)
+            if (_shrts[i] != '\0' && !_need_argument[i]) set.set(_shrts[i]);
+        return set;
+    }();
+
+    static constexpr size_t _long_nums = [] {
+        size_t nums = 0;
+        for (auto lng : _lngs) nums += !lng.empty();
+        return nums;
+    }();
+
+    static constexpr auto _long_flags = [] {
+        std::array<std::pair<std::string_view, size_t>, _long_nums> table{};
+        for (size_t i = 0, j = 0; i < _size; ++i)
+            if (!_lngs[i].empty()) table[j++] = {_lngs[i], i};
+        std::sort(table.begin(), table.end());
+        return table;
+    }();
+
+    static constexpr bool _has_flags() {
+        for (size_t i = 0; i < _size; ++i)
+            if (!_ignored[i] && _shrts[i] == '\0' && _lngs[i].empty())
+                return false;
+        return true;
+    }
+
+    static constexpr bool _printable_shrts() {
+        for (char shrt : _shrts)
+            if (shrt != '\0' && (shrt < '!' || shrt > '~' || shrt == '-'))
+                return false;
+        return true;
+    }
+
+    static constexpr bool _unique_shrts() {
+        for (size_t i = 0; i < _size; ++i)
+            for (size_t j = i + 1; j < _size; ++j)
+                if (_shrts[i] != '\0' && _shrts[i] == _shrts[j]) return false;
+        return true;
+    }
+
+    static constexpr bool _unique_lngs() {
+        for (size_t i = 1; i < _long_nums; ++i)
+            if (_long_flags[i - 1].first == _long_flags[i].first) return false;
+        return true;
+    }
+
+    static_assert(
+        (size_t{0} + ... + _detail::static_traits<OptionTs>::ignored) <= 1,
+        "can only provide 0 or 1 `greet::ignored` or `greet::ignored_view` "
+        "option!");
+    static_assert(
+        _has_flags(),
+        "there is an option that specifies neither short nor long flags.");
+    static_assert(
+        _printable_shrts(),
+        "the short flag must be a printable character and cannot be '-'.");
+    static_assert(_unique_shrts(), "a short flag is already be used.");
+    static_assert(_unique_lngs(), "a long flag is already be used.");
+
+    template <typename FnT>
+    void _visit(size_t index, FnT &&fn) const;
+
+    std::tuple<OptionTs...> _opts;
+};
+
+template <typename... OptionTs>
+static_meta(OptionTs...) -> static_meta<OptionTs...>;
+
+/// A cheap reference to an option of `greet::static_meta`, it has the same
+/// interface as what the parse loop uses from `greet::meta`.
+template <typename... OptionTs>
+class static_meta<OptionTs...>::handle {
+  public:
+    handle() : opttype{_detail::NORMAL}, _meta{nullptr}, _index{0} {}
+    handle(const static_meta &m, size_t index) :
+        opttype{_opttypes[index]}, _meta{&m}, _index{index} {}
+
+    size_t opttype;
+
+    explicit operator bool() const { return _meta; }
+    handle *operator->() { return this; }
+    const handle *operator->() const { return this; }
+    handle &operator*() { return *this; }
+    const handle &operator*() const { return *this; }
+
+    char shrt() const { return _shrts[_index]; }
+    std::string_view lng() const { return _lngs[_index]; }
+    bool required() const { return _required[_index]; }
+    bool need_argument() const { return _need_argument[_index]; }
+    bool single() const { return _single[_index]; }
+    size_t index() const { return _index; }
+
+    std::string_view about() const {
+        if (_index == _help_index) return "Print help";
+        if (_index == _version_index) return "Print version";
+        std::string_view result;
+        _meta->_visit(_index, [&](const auto &opt) {
+            if constexpr (!_detail::static_traits<
+                              std::decay_t<decltype(opt)>>::ignored)
+                result = opt.get_about();
+        });
+        return result;
+    }
+
+    std::string_view argname() const {
+        std::string_view result;
+        _meta->_visit(_index, [&](const auto &opt) {
+            if constexpr (_detail::static_traits<
+                              std::decay_t<decltype(opt)>>::need_argument)
+                result = opt.get_argname();
+        });
+        return result;
+    }
+
+    bool allow_hyphen() const {
+        bool result = false;
+        _meta->_visit(_index, [&](const auto &opt) {
+            if constexpr (_detail::static_traits<
+                              std::decay_t<decltype(opt)>>::need_argument)
+                result = opt.get_allow_hyphen();
+        });
+        return result;
+    }
+
+    std::string def() const {
+        std::string result;
+        _meta->_visit(_index, [&](const auto &opt) {
+            if constexpr (!_detail::static_traits<
+                              std::decay_t<decltype(opt)>>::ignored)
+                result = opt.get_def();
+        });
+        return result;
+    }
+
+    std::span<const std::string_view> choices() const {
+        std::span<const std::string_view> result;
+        _meta->_visit(_index, [&](const auto &opt) {
+            if constexpr (!_detail::static_traits<
+                              std::decay_t<decltype(opt)>>::ignored)
+                result = opt.get_choices();
+        });
+        return result;
+    }
+
+    std::errc set(std::ptrdiff_t offset, std::string_view value = {}) {
+        std::errc ec{};
+        _meta->_visit(_index, [&](const auto &opt) {
+            if constexpr (!_detail::static_traits<
+                              std::decay_t<decltype(opt)>>::ignored)
+                ec = opt.set(offset, value);
+        });
+        return ec;
+    }
+
+  private:
+    const static_meta *_meta;
+    size_t _index;
+};
+
+template <typename... OptionTs>
+constexpr static_meta<OptionTs...>::static_meta(OptionTs... options) :
+    _opts(std::move(options)...) {}
+
+template <typename... OptionTs>
+auto static_meta<OptionTs...>::lookup(char flag) const -> handle {
+    if (flag < '!' || flag > '~' || !_short_flags[flag - '!']) return {};
+    return handle(*this, _short_flags[flag - '!'] - 1);
+}
+
+template <typename... OptionTs>
+const _detail::char_set &static_meta<OptionTs...>::switches() const {
+    return _switches;
+}
+
+template <typename... OptionTs>
+auto static_meta<OptionTs...>::lookup(std::string_view flag) const
+    -> handle {
+    auto found = std::lower_bound(
+        _long_flags.begin(),
+        _long_flags.end(),
+        flag,
+        [](const auto &item, std::string_view value) {
+            return item.first < value;
+        });
+    if (found == _long_flags.end() || found->first != flag) return {};
+    return handle(*this, found->second);
+}
+
+template <typename... OptionTs>
+void static_meta<OptionTs...>::complete(
+    std::string_view partial, _detail::string &out) const {
+    if (partial == "-")
+        for (char shrt : _shrts)
+            if (shrt != '\0') {
+                out += '-';
+                out += shrt;
+                out += '\n';
+            }
+    if (partial == "-" || partial.starts_with("--"))
+        _detail::append_long_flags(
+            _long_flags, partial.substr(std::min<size_t>(partial.size(), 2)),
+            out);
+}
+
+template <typename... OptionTs>
+std::vector<std::string> static_meta<OptionTs...>::suggest(
+    std::string_view flag) const {
+    return _detail::similar_flags(_long_flags, flag);
+}
+
+template <typename... OptionTs>
+bool static_meta<OptionTs...>::help(const state_type &flags) const {
+    return flags.test(_help_index);
+}
+
+template <typename... OptionTs>
+bool static_meta<OptionTs...>::version(const state_type &flags) const {
+    return flags.test(_version_index);
+}
+
+template <typename... OptionTs>
+void static_meta<OptionTs...>::store_ignored(
+    std::ptrdiff_t offset, std::span<const char *const> tail) const {
+    [&]<size_t... I>(std::index_sequence<I...>) {
+        auto store = [&](auto &opt) {
+            using option_type = std::decay_t<decltype(opt)>;
+            if constexpr (std::is_same_v<
+                              option_type,
+                              std::reference_wrapper<ignored_view>>) {
+                _detail::rebase(opt.get(), offset) =
+                    ignored_view(tail.data(), tail.size());
+            } else if constexpr (std::is_same_v<
+                                     option_type,
+                                     std::reference_wrapper<ignored>>) {
+                auto &target = _detail::rebase(opt.get(), offset);
+                target.reserve(tail.size());
+                for (const char *arg : tail) target.emplace_back(arg);
+            }
+        };
+        (store(std::get<I>(_opts)), ...);
+    }(std::index_sequence_for<OptionTs...>{});
+}
+
+template <typename... OptionTs>
+std::vector<std::string> static_meta<OptionTs...>::missing_opts(
+    const state_type &flags) const {
+    std::vector<std::string> missing{};
+    for (size_t i = 0; i < _size; ++i)
+        if (_required[i] && !flags.test(i)) {
+            handle optref(*this, i);
+            if (optref.lng().empty())
+                missing.emplace_back(std::format(
+                    "-{} <{}>", optref.shrt(), _detail::get_argname(optref)));
+            else
+                missing.emplace_back(std::format(
+                    "--{} <{}>", optref.lng(), _detail::get_argname(optref)));
+        }
+    return missing;
+}
+
+template <typename... OptionTs>
+_detail::vector<_detail::opt_info> static_meta<OptionTs...>::describe_opts()
+    const {
+    _detail::vector<_detail::opt_info> infos;
+    infos.reserve(_size);
+    for (size_t i = 0; i < _size; ++i)
+        if (!_ignored[i])
+            infos.emplace_back(_detail::describe(handle(*this, i)));
+    return infos;
+}
+
+template <typename... OptionTs>
+template <typename FnT>
+void static_meta<OptionTs...>::_visit(size_t index, FnT &&fn) const {
+    // a jump table indexed by the position of the option, the built-in `-h`
+    // and `-V` have no entries
+    using entry = void (*)(const static_meta &, FnT &);
+    static constexpr auto table = []<size_t... I>(std::index_sequence<I...>) {
+        return std::array<entry, sizeof...(OptionTs)>{
+            [](const static_meta &m, FnT &fn) { fn(std::get<I>(m._opts)); }...};
+    }(std::index_sequence_for<OptionTs...>{});
+    if (index < table.size()) table[index](*this, fn);
+}
+
+namespace _detail {
+    template <typename MetaT>
+    constexpr bool is_static_meta = false;
+
+    template <typename... OptionTs>
+    constexpr bool is_static_meta<static_meta<OptionTs...>> = true;
+}  // namespace _detail
+
+template <typename ArgsGroupT>
+concept static_args_group =
+    std::derived_from<ArgsGroupT, static_information> &&
+    std::default_initializable<ArgsGroupT> && std::movable<ArgsGroupT> &&
+    requires(ArgsGroupT &args) {
+        requires _detail::is_static_meta<decltype(args.genmeta())>;
+    };
+
+namespace _detail {
+    template <typename ArgsGroupT>
+    concept any_args_group =
+        args_group<ArgsGroupT> || static_args_group<ArgsGroupT>;
+}  // namespace _detail
+
+template <char Shrt, _detail::fixed_string Lng = "", typename OptT>
+constexpr auto opt(OptT &optref) {
+    return _detail::static_opt<OptT, Shrt, Lng>(optref);
+}
+
+template <_detail::fixed_string Lng, typename OptT>
+constexpr auto opt(OptT &optref) {
+    return _detail::static_opt<OptT, '\0', Lng>(optref);
+}
+
+namespace _detail {
+    template <typename... OptionTs>
+    auto lookup(const static_meta<OptionTs...> &m, char flag) {
+        return m.lookup(flag);
+    }
+
+    template <typename... OptionTs>
+    auto lookup(const static_meta<OptionTs...> &m, std::string_view flag) {
+        return m.lookup(flag);
+    }
+
+    template <typename... OptionTs>
+    const char_set &switches_of(const static_meta<OptionTs...> &m) {
+        return m.switches();
+    }
+
+    template <typename... OptionTs>
+    auto parse_state(const static_meta<OptionTs...> &) {
+        return typename static_meta<OptionTs...>::state_type{};
+    }
+
+    template <typename... OptionTs>
+    size_t index_of(
+        const static_meta<OptionTs...> &,
+        const typename static_meta<OptionTs...>::handle &optref) {
+        return optref.index();
+    }
+
+    template <typename... OptionTs>
+    void store_ignored(
+        const static_meta<OptionTs...> &m, std::ptrdiff_t offset,
+        std::span<const char *const> tail) {
+        m.store_ignored(offset, tail);
+    }
+
+    template <typename... OptionTs>
+    std::vector<std::string> missing_opts(
+        const static_meta<OptionTs...> &m,
+        const typename static_meta<OptionTs...>::state_type &flags) {
+        return m.missing_opts(flags);
+    }
+
+    template <typename... OptionTs>
+    vector<opt_info> describe_opts(const static_meta<OptionTs...> &m) {
+        return m.describe_opts();
+    }
+
+    // compile-time schemas do not support positionals and subcommands
+    template <typename... OptionTs>
+    std::span<const anyopt *const> positionals_of(
+        const static_meta<OptionTs...> &) {
+        return {};
+    }
+
+    template <typename... OptionTs>
+    const anyopt *commands_of(const static_meta<OptionTs...> &) {
+        return nullptr;
+    }
+
+    /// Cut the next whitespace separated token out of `[pos, end)` in place.
+    /// Quotes are removed and backslash escapes resolved, then the token is
+    /// null terminated, so `*end` must be writable.
+    GREET_INLINE std::optional<std::string_view> next_token(
+        char *&pos, char *end);
+
+#ifdef GREET_DEFINITIONS
+    GREET_INLINE std::optional<std::string_view> next_token(
+        char *&pos, char *end) {
+        auto space = [](char c) {
+            return std::isspace(static_cast<unsigned char>(c)) != 0;
+        };
+        while (pos != end && space(*pos)) ++pos;
+        if (pos == end) return std::nullopt;
+
+        char *start = pos, *out = pos;
+        char quote = '\0';
+        for (; pos != end; ++pos) {
+            char c = *pos;
+            if (quote) {
+                if (c == quote) {
+                    quote = '\0';
+                    continue;
+                }
+                // only `\"` and `\\` are escapes inside double quotes
+                if (c == '\\' && quote == '"' && pos + 1 != end &&
+                    (pos[1] == '"' || pos[1] == '\\'))
+                    c = *++pos;
+            } else {
+                if (space(c)) break;
+                if (c == '\'' || c == '"') {
+                    quote = c;
+                    continue;
+                }
+                if (c == '\\' && pos + 1 != end) c = *++pos;
+            }
+            *out++ = c;
+        }
+        if (pos != end) ++pos;
+        *out = '\0';
+        return std::string_view(start, out);
+    }
+#endif
+
+    /// A file loaded into writable memory with a zeroed byte past its end,
+    /// which is released with the buffer.
+    class file_buffer {
+      public:
+        file_buffer() = default;
+        file_buffer(const file_buffer &) = delete;
+        file_buffer(file_buffer &&other) noexcept;
+        file_buffer &operator=(file_buffer &&other) noexcept;
+        ~file_buffer();
+
+        /// Load the regular file at `path`, nothing if it cannot be read.
+        static std::optional<file_buffer> open(const char *path);
+
+        char *begin() const { return _data; }
+        char *end() const { return _data + _size; }
+
+        // the identity of the file, to tell whether two paths name it
+        std::uintmax_t dev = 0;
+        std::uintmax_t ino = 0;
+
+      private:
+        void _release();
+
+        char *_data = nullptr;
+        size_t _size = 0;
+#if __has_include(<sys/mman.h>)
+        // the length of the mapping, which is 0 for no mapping
+        size_t _mapped = 0;
+#endif
+    };
+
+#ifdef GREET_DEFINITIONS
+    GREET_INLINE file_buffer::file_buffer(file_buffer &&other) noexcept {
+        *this = std::move(other);
+    }
+
+    GREET_INLINE file_buffer &
+    file_buffer::operator=(file_buffer &&other) noexcept {
+        if (this == &other) return *this;
+        _release();
+        dev = other.dev;
+        ino = other.ino;
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+#if __has_include(<sys/mman.h>)
+        _mapped = std::exchange(other._mapped, 0);
+#endif
+        return *this;
+    }
+
+    GREET_INLINE file_buffer::~file_buffer() { _release(); }
+
+#if __has_include(<sys/mman.h>)
+    GREET_INLINE void file_buffer::_release() {
+        if (_mapped) ::munmap(_data, _mapped);
+        _data = nullptr;
+        _size = _mapped = 0;
+    }
+
+    GREET_INLINE std::optional<file_buffer>
+    file_buffer::open(const char *path) {
+        int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return std::nullopt;
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            ::close(fd);
+            return std::nullopt;
+        }
+
+        // a private mapping is tokenized in place without touching the file,
+        // the anonymous mapping below it provides a zeroed byte past the end
+        size_t size = static_cast<size_t>(st.st_size);
+        void *base = ::mmap(
+            nullptr,
+            size + 1,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS,
+            -1,
+            0);
+        if (base != MAP_FAILED && size &&
+            ::mmap(
+                base,
+                size,
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_FIXED,
+                fd,
+                0) == MAP_FAILED) {
+            ::munmap(base, size + 1);
+            base = MAP_FAILED;
+        }
+        ::close(fd);
+        if (base == MAP_FAILED) return std::nullopt;
+
+        std::optional<file_buffer> file(std::in_place);
+        file->dev = static_cast<std::uintmax_t>(st.st_dev);
+        file->ino = static_cast<std::uintmax_t>(st.st_ino);
+        file->_data = static_cast<char *>(base);
+        file->_size = size;
+        file->_mapped = size + 1;
+        return file;
+    }
+#else
+    GREET_INLINE void file_buffer::_release() {
+        delete[] _data;
+        _data = nullptr;
+        _size = 0;
+    }
+
+    GREET_INLINE std::optional<file_buffer>
+    file_buffer::open(const char *path) {
+        std::FILE *stream = std::fopen(path, "rb");
+        if (!stream) return std::nullopt;
+        std::string content;
+        char buffer[4096];
+        size_t count;
+        while ((count = std::fread(buffer, 1, sizeof(buffer), stream)))
+            content.append(buffer, count);
+        std::fclose(stream);
+
+        std::optional<file_buffer> file(std::in_place);
+        // no file identity here, files are told apart by their paths
+        file->ino = std::hash<std::string_view>{}(path);
+        file->_data = new char[content.size() + 1];
+        file->_size = content.size();
+        std::memcpy(file->_data, content.data(), content.size());
+        file->_data[content.size()] = '\0';
+        return file;
+    }
+#endif
+#endif
+
+    /// The part of an expanded response file which is not tokenized yet.
+    struct response_file {
+        char *pos;
+        char *end;
+        std::uintmax_t dev;
+        std::uintmax_t ino;
+    };
+}  // namespace _detail
+
+/// The response files expanded by parses and the argument lists spliced from
+/// them, which are released with it.
+///
+/// Passing one to `greet::greet()`, `greet::try_greet()` or `greet::parser`
+/// turns on the expansion of `@path` tokens, and values viewing the expanded
+/// tokens, such as `std::string_view`, must not outlive it. Without one,
+/// `@path` is an ordinary argument.
+class response_files {
+  public:
+    response_files() = default;
+    response_files(const response_files &) = delete;
+    response_files(response_files &&) = default;
+    response_files &operator=(response_files &&) = default;
+
+  private:
+    friend class _detail::token_stream;
+
+    std::vector<_detail::file_buffer> _files;
+    std::vector<std::vector<const char *>> _spliced;
+};
+
+namespace _detail {
+    /// The tokens of an argument list after the program name. With `files`,
+    /// a `@path` token is replaced by the tokens of the response file at
+    /// `path` unless the file cannot be read, and `@@` stands for a literal
+    /// `@`, the files and spliced tokens are owned by `files`.
+    class token_stream {
+      public:
+        explicit token_stream(
+            std::span<const char *const> args,
+            response_files *files = nullptr);
+
+        bool empty() const;
+        // the current token, which is always null terminated
+        std::string_view front() const;
+        void pop();
+        // index of the token in the argument list, response files count as
+        // the `@path` token which expanded them
+        size_t index() const;
+        // take the remaining tokens without expanding response files
+        std::span<const char *const> rest();
+        const std::optional<error> &failure() const;
+        // size of the argument list
+        size_t end() const;
+
+      private:
+        void _advance();
+
+        std::span<const char *const> _args;
+        response_files *_owner;
+        size_t _next = 1;
+        vector<response_file> _files;
+        std::optional<std::string_view> _front;
+        std::optional<error> _failure;
+    };
+
+    inline token_stream::token_stream(
+        std::span<const char *const> args, response_files *files) :
+        _args(args), _owner(files) {
+        _advance();
+    }
+
+    inline bool token_stream::empty() const { return !_front; }
+
+    inline std::string_view token_stream::front() const { return *_front; }
+
+    inline void token_stream::pop() { _advance(); }
+
+    inline size_t token_stream::index() const { return _next - 1; }
+
+    inline std::span<const char *const> token_stream::rest() {
+        _front.reset();
+        if (_files.empty()) {
+            auto tail = _args.subspan(std::min(_next, _args.size()));
+            _next = _args.size();
+            return tail;
+        }
+
+        std::vector<const char *> tokens;
+        for (; !_files.empty(); _files.pop_back()) {
+            auto &file = _files.back();
+            while (auto token = next_token(file.pos, file.end))
+                tokens.push_back(token->data());
+        }
+        for (; _next < _args.size(); ++_next) tokens.push_back(_args[_next]);
+        return _owner->_spliced.emplace_back(std::move(tokens));
+    }
+
+    inline const std::optional<error> &token_stream::failure() const {
+        return _failure;
+    }
+
+    inline size_t token_stream::end() const { return _args.size(); }
+
+    inline void token_stream::_advance() {
+        _front.reset();
+        while (true) {
+            std::string_view token;
+            if (!_files.empty()) {
+                auto next = next_token(_files.back().pos, _files.back().end);
+                if (!next) {
+                    _files.pop_back();
+                    continue;
+                }
+                token = *next;
+            } else if (_next < _args.size()) {
+                token = _args[_next++];
+            } else {
+                return;
+            }
+
+            if (_owner && token.starts_with("@@")) {
+                // still null terminated
+                token.remove_prefix(1);
+            } else if (_owner && token.size() > 1 && token.starts_with('@')) {
+                if (auto file = file_buffer::open(token.data() + 1)) {
+                    bool cycle = std::ranges::any_of(_files, [&](auto &other) {
+                        return other.dev == file->dev && other.ino == file->ino;
+                    });
+                    if (cycle) {
+                        _failure = error{
+                            .kind = error_kind::recursive_response_file,
+                            .flag = {},
+                            .value = std::string(token.substr(1)),
+                            .argname = {},
+                            .index = index(),
+                            .ec = {},
+                            .missing = {},
+                            .commands = {},
+                            .suggestions = {},
+                            .location = {},
+                        };
+                        return;
+                    }
+                    _files.push_back(response_file{
+                        .pos = file->begin(),
+                        .end = file->end(),
+                        .dev = file->dev,
+                        .ino = file->ino,
+                    });
+                    _owner->_files.push_back(std::move(*file));
+                    continue;
+                }
+            }
+            _front = token;
+            return;
+        }
+    }
+
+}  // namespace _detail
+
+/// Values of long options from an INI file, a lower layer than the command
+/// line: options given in the argument list keep their values.
+///
+/// Each `key = value` line sets the option whose long flag is `key`, keys
+/// below a `[section]` line are prefixed by `section.`. Values may be quoted
+/// like in response files, lines starting with `#` or `;` are comments.
+/// BOOLEAN options take `true`, `false`, `1` or `0`, COUNTER ones take a
+/// count, and VECTOR ones may be repeated. The file is mapped and parsed
+/// once, options viewing its values, such as `std::string_view`, must not
+/// outlive the config file and its copies.
+class config_file {
+  public:
+    struct entry {
+        // the long flag without leading "--", a view like the value
+        std::string_view key;
+        std::string_view value;
+        size_t line;
+    };
+
+    /// A file which cannot be read has no entries.
+    explicit config_file(const char *path);
+
+    bool loaded() const { return _loaded; }
+    const std::string &path() const { return _path; }
+    const std::vector<entry> &entries() const { return _entries; }
+    // why the file is malformed, reported when it is used
+    const std::optional<error> &failure() const { return _failure; }
+
+  private:
+    // what the entries view, shared by the copies
+    struct storage {
+        _detail::file_buffer file;
+        // keys below a section, joined with it
+        std::string keys;
+    };
+
+    std::string _path;
+    std::shared_ptr<const storage> _storage;
+    std::vector<entry> _entries;
+    std::optional<error> _failure;
+    bool _loaded;
+};
+
+#ifdef GREET_DEFINITIONS
+GREET_INLINE config_file::config_file(const char *path) :
+    _path(path), _loaded(false) {
+    auto file = _detail::file_buffer::open(path);
+    if (!file) return;
+    _loaded = true;
+    auto stored = std::make_shared<storage>(std::move(*file), std::string{});
+
+    auto space = [](char c) {
+        return std::isspace(static_cast<unsigned char>(c)) != 0;
+    };
+    auto trim = [&](std::string_view text) {
+        while (!text.empty() && space(text.front())) text.remove_prefix(1);
+        while (!text.empty() && space(text.back())) text.remove_suffix(1);
+        return text;
+    };
+
+    std::string_view section;
+    // the entries below a section and the section, joined after every line
+    // is read so that the keys never move
+    std::vector<std::pair<size_t, std::string_view>> sectioned;
+    size_t line = 0;
+    char *last = stored->file.end();
+    for (char *pos = stored->file.begin(); pos != last;) {
+        ++line;
+        auto eol = static_cast<char *>(std::memchr(pos, '\n', last - pos));
+        if (!eol) eol = last;
+        std::string_view text = trim(std::string_view(pos, eol));
+        pos = eol == last ? eol : eol + 1;
+        if (text.empty() || text.starts_with('#') || text.starts_with(';'))
+            continue;
+
+        size_t split = text.find('=');
+        if (text.starts_with('[') && text.ends_with(']')) {
+            section = trim(text.substr(1, text.size() - 2));
+            continue;
+        } else if (split == std::string_view::npos) {
+            _failure = error{
+                .kind = error_kind::unexpected_argument,
+                .flag = {},
+                .value = std::string(text),
+                .argname = {},
+                .index = line,
+                .ec = {},
+                .missing = {},
+                .commands = {},
+                .suggestions = {},
+                .location = std::format("{}:{}", _path, line),
+            };
+            _storage = std::move(stored);
+            return;
+        }
+
+        std::string_view key = trim(text.substr(0, split));
+        std::string_view value = trim(text.substr(split + 1));
+        // resolve quotes in place, then terminate the value, which may end
+        // at the zeroed byte past the end of the file
+        char *begin = const_cast<char *>(value.data());
+        char *end = begin + value.size();
+        if (value.starts_with('"') || value.starts_with('\'')) {
+            auto token = _detail::next_token(begin, end);
+            value = token ? *token : std::string_view(begin, begin);
+        } else {
+            *end = '\0';
+        }
+        if (!section.empty()) sectioned.emplace_back(_entries.size(), section);
+        _entries.push_back(entry{.key = key, .value = value, .line = line});
+    }
+
+    size_t size = 0;
+    for (const auto &[index, name] : sectioned)
+        size += name.size() + 1 + _entries[index].key.size();
+    stored->keys.reserve(size);
+    for (const auto &[index, name] : sectioned) {
+        std::string_view &key = _entries[index].key;
+        size_t start = stored->keys.size();
+        stored->keys.append(name).append(1, '.').append(key);
+        key = std::string_view(stored->keys).substr(start);
+    }
+    _storage = std::move(stored);
+}
+#endif
+
+namespace _detail {
+    // Set `optref` from a value outside the argument list: BOOLEAN options
+    // take `true`, `false`, `1` or `0`, and COUNTER ones take a count.
+    inline std::errc set_setting(
+        const anyopt &optref, std::ptrdiff_t offset, std::string_view value) {
+        if (optref.opttype == BOOLEAN) {
+            if (value == "true" || value == "1")
+                optref.set(offset);
+            else if (value != "false" && value != "0")
+                return std::errc::invalid_argument;
+            return {};
+        } else if (optref.opttype == COUNTER) {
+            auto times = from_str<size_t>(value);
+            if (!times) return times.error();
+            for (size_t i = 0; i < *times; ++i) optref.set(offset);
+            return {};
+        }
+        return optref.set(offset, value);
+    }
+
+    inline std::unexpected<error> config_error(
+        error_kind kind, const config_file &config,
+        const config_file::entry &entry, const anyopt *optref,
+        std::errc ec = {}) {
+        return std::unexpected(error{
+            .kind = kind,
+            .flag = optref ? std::format("--{}", entry.key) : std::string{},
+            .value = std::string(optref ? entry.value : entry.key),
+            // config values also belong to flags without arguments
+            .argname = optref ? std::string(get_argname(*optref))
+                              : std::string{},
+            .index = entry.line,
+            .ec = ec,
+            .missing = {},
+            .commands = {},
+            .suggestions = {},
+            .location = std::format("{}:{}", config.path(), entry.line),
+        });
+    }
+
+    // Set the options of `config` not in `given` through `set`, then add them
+    // to `given` for the lower layers. The single ones are marked in `flags`.
+    // `set` takes the option, the prefix and name its value comes from, the
+    // value and the index of the token or line, like `set_setting()`.
+    template <typename SetT>
+    auto apply_config(
+        const meta &m, const config_file &config, set_flags &flags,
+        set_flags &given, SetT &&set) -> std::expected<void, error> {
+        if (config.failure()) return std::unexpected(*config.failure());
+        set_flags seen(m.opts().size());
+        for (const auto &entry : config.entries()) {
+            auto found = m.query(entry.key);
+            if (!found)
+                return config_error(
+                    error_kind::unexpected_argument, config, entry, nullptr);
+            const anyopt &optref = found.value().get();
+            size_t index = m.index_of(optref);
+            if (given.test(index)) continue;
+            if (optref.single() && seen.test(index))
+                return config_error(
+                    error_kind::used_multiple, config, entry, &optref);
+            seen.set(index);
+
+            std::errc ec =
+                set(optref, "--", entry.key, entry.value, entry.line);
+            if (ec != std::errc{})
+                return config_error(
+                    value_error(ec), config, entry, &optref, ec);
+            if (optref.single()) flags.set(index);
+        }
+        for (size_t i = 0; i < m.opts().size(); ++i)
+            if (seen.test(i)) given.set(i);
+        return {};
+    }
+
+    // Set the options with an environment variable not in `given` through
+    // `set`, see `apply_config()`, then add them to `given`. The environment
+    // is walked once and each name is looked up by its hash, instead of one
+    // `getenv()` per option.
+    template <typename SetT>
+    auto apply_env(
+        const meta &m, set_flags &flags, set_flags &given, SetT &&set)
+        -> std::expected<void, error> {
+        const auto &vars = m.env_vars();
+        if (vars.empty()) return {};
+#ifdef _WIN32
+        char **env = _environ;
+#else
+        char **env = environ;
+#endif
+        for (; env && *env; ++env) {
+            std::string_view var = *env;
+            size_t split = var.find('=');
+            if (split == std::string_view::npos) continue;
+            std::string_view name = var.substr(0, split);
+            auto candidates = std::ranges::equal_range(
+                vars, hash_name(name), {}, [](const auto &var) {
+                    return var.first;
+                });
+            for (const auto &candidate : candidates) {
+                const anyopt &optref = *candidate.second;
+                if (optref.env() != name) continue;
+                size_t index = m.index_of(optref);
+                if (given.test(index)) break;
+
+                std::string_view value = var.substr(split + 1);
+                std::errc ec = set(optref, "$", name, value, 0);
+                if (ec != std::errc{})
+                    return std::unexpected(error{
+                        .kind = value_error(ec),
+                        .flag = std::format("${}", name),
+                        .value = std::string(value),
+                        .argname = std::string(get_argname(optref)),
+                        .index = 0,
+                        .ec = ec,
+                        .missing = {},
+                        .commands = {},
+                        .suggestions = {},
+                        .location = {},
+                    });
+                if (optref.single()) flags.set(index);
+                given.set(index);
+                break;
+            }
+        }
+        return {};
+    }
+
+    // An observer which converts the values itself later, see
+    // `greet::reloader`. Values of flags without arguments are empty, values
+    // from the environment and config files are marked as settings, which
+    // are converted with `set_setting()`.
+    template <typename ObserverT>
+    concept deferring_observer = requires(
+        ObserverT &observer, size_t option, std::string_view text,
+        size_t token) { observer.defer(option, text, text, token, true); };
+
+    // Measures the time since it was constructed, only for real observers.
+    template <typename ObserverT>
+    class stopwatch {
+      public:
+        std::chrono::nanoseconds elapsed() const {
+            return std::chrono::steady_clock::now() - _start;
+        }
+
+      private:
+        std::chrono::steady_clock::time_point _start =
+            std::chrono::steady_clock::now();
+    };
+
+    template <>
+    class stopwatch<null_observer> {
+      public:
+        std::chrono::nanoseconds elapsed() const { return {}; }
+    };
+
+    // A value of a deferred option, see `opt_wrapper::deferred()`.
+    struct pending_value {
+        const anyopt *optref;
+        // the long flag as written, empty for short flags and positionals
+        std::string_view flag;
+        bool shrt;
+        std::string_view value;
+        // index of the token of the value
+        size_t index;
+    };
+
+    // Parse the remaining tokens of `tokens`, a subcommand continues parsing
+    // the stream of its parent. `m` is only read, everything a parse changes
+    // lives on this stack frame, so threads can share a schema. The events
+    // are reported to `observer`, and options not given in `tokens` are
+    // taken from `configs`, the first one wins.
+    template <typename MetaT, typename ObserverT>
+    auto parse_stream(
+        const MetaT &m, std::ptrdiff_t offset, token_stream &tokens,
+        ObserverT &observer,
+        std::span<const config_file *const> configs = {})
+        -> std::expected<void, error> {
+        auto find = [&](auto key, std::string_view flag) {
+            auto optref = lookup(m, key);
+            observer.on_lookup(flag, static_cast<bool>(optref));
+            return optref;
+        };
+
+        // which options have been set, to report repeated and missing ones
+        auto flags = parse_state(m);
+        // which options have been given, only tracked for the lower layers
+        std::optional<set_flags> given;
+        if constexpr (!is_static_meta<MetaT>)
+            if (!configs.empty() || !m.env_vars().empty())
+                given.emplace(m.opts().size());
+        auto mark = [&](const auto &optref) {
+            if (optref->single()) flags.set(index_of(m, optref));
+            if constexpr (!is_static_meta<MetaT>)
+                if (given) given->set(index_of(m, optref));
+        };
+        // the part of the current token that has not been parsed yet
+        std::string_view cur;
+        auto next_arg = [&] {
+            cur = tokens.empty() ? std::string_view{} : tokens.front();
+        };
+        auto remove_one_arg = [&] {
+            tokens.pop();
+            next_arg();
+        };
+        next_arg();
+        // index of the token which is being parsed
+        size_t index = 0;
+        // values of deferred options, converted in bulk by `flush()`
+        std::vector<pending_value> pending;
+        // a deferring observer takes the values instead of the options
+        auto convert = [&](auto optref, std::string_view flag,
+                           std::string_view value) {
+            if constexpr (deferring_observer<ObserverT>) {
+                observer.defer(
+                    index_of(m, optref), flag, value, index, false);
+                return std::errc{};
+            } else {
+                if constexpr (!is_static_meta<MetaT>)
+                    if (optref->opttype == VECTOR && optref->deferred()) {
+                        // short flags are views into this frame
+                        bool shrt = flag.size() == 2 && flag[1] != '-';
+                        pending.push_back(pending_value{
+                            .optref = optref,
+                            .flag = shrt ? std::string_view{} : flag,
+                            .shrt = shrt,
+                            .value = value,
+                            .index = index,
+                        });
+                        return std::errc{};
+                    }
+                stopwatch<ObserverT> watch;
+                std::errc ec = optref->set(offset, value);
+                observer.on_conversion(value, ec, watch.elapsed());
+                return ec;
+            }
+        };
+        // Convert the pending values, the one in error nearest to the front
+        // is reported as if it had been converted while scanning.
+        auto flush = [&]() -> std::expected<void, error> {
+            if (pending.empty()) return {};
+            std::ranges::stable_sort(pending, {}, &pending_value::optref);
+            std::vector<std::string_view> values;
+            const pending_value *bad = nullptr;
+            std::errc bad_ec{};
+            for (auto first = pending.begin(); first != pending.end();) {
+                auto last = std::find_if(first, pending.end(), [&](auto &v) {
+                    return v.optref != first->optref;
+                });
+                values.clear();
+                for (auto it = first; it != last; ++it)
+                    values.push_back(it->value);
+                stopwatch<ObserverT> watch;
+                size_t failed = 0;
+                std::errc ec = first->optref->set_many(offset, values, failed);
+                auto elapsed = watch.elapsed() / values.size();
+                for (size_t i = 0; i < values.size(); ++i)
+                    observer.on_conversion(
+                        values[i], i == failed ? ec : std::errc{}, elapsed);
+                if (ec != std::errc{} &&
+                    (!bad || first[failed].index < bad->index)) {
+                    bad = &first[failed];
+                    bad_ec = ec;
+                }
+                first = last;
+            }
+            pending.clear();
+            if (!bad) return {};
+            return std::unexpected(error{
+                .kind = value_error(bad_ec),
+                .flag = bad->shrt ? std::format("-{}", bad->optref->shrt())
+                                  : std::string(bad->flag),
+                .value = std::string(bad->value),
+                .argname = std::string(get_argname(*bad->optref)),
+                .index = bad->index,
+                .ec = bad_ec,
+                .missing = {},
+                .commands = {},
+                .suggestions = {},
+                .location = {},
+            });
+        };
+        auto fail = [&](error_kind kind, std::string_view flag,
+                        auto optref, std::string_view value = {},
+                        std::errc ec = {}) -> std::unexpected<error> {
+            // an earlier value in error is reported first
+            if (auto flushed = flush(); !flushed)
+                return std::unexpected(std::move(flushed.error()));
+            // a broken response file is what cut the tokens short
+            if (tokens.failure()) return std::unexpected(*tokens.failure());
+            std::string argname{};
+            if constexpr (!std::is_null_pointer_v<decltype(optref)>)
+                if (optref->need_argument()) argname = get_argname(*optref);
+            return std::unexpected(error{
+                .kind = kind,
+                .flag = std::string(flag),
+                .value = std::string(value),
+                .argname = std::move(argname),
+                .index = index,
+                .ec = ec,
+                .missing = {},
+                .commands = {},
+                .suggestions = {},
+                .location = {},
+            });
+        };
+
+        // positionals are filled in order, the last one may take many values
+        std::span<const anyopt *const> positionals = positionals_of(m);
+        size_t slot = 0;
+        auto positional = [&](std::string_view value)
+            -> std::expected<bool, error> {
+            if constexpr (is_static_meta<MetaT>) {
+                return false;
+            } else {
+                if (slot == positionals.size()) return false;
+                const anyopt *optref = positionals[slot];
+                if (optref->opttype != VECTOR) ++slot;
+                std::errc ec = convert(optref, {}, value);
+                if (ec != std::errc{})
+                    return fail(
+                        value_error(ec), {}, optref, value, ec);
+                mark(optref);
+                return true;
+            }
+        };
+
+        // an option which takes no argument
+        auto set_switch = [&](std::string_view flag, auto optref)
+            -> std::expected<bool, error> {
+            if (flags.test(index_of(m, optref)))
+                return fail(error_kind::used_multiple, flag, optref);
+            if constexpr (deferring_observer<ObserverT>)
+                observer.defer(index_of(m, optref), flag, {}, index, false);
+            else
+                optref->set(offset);
+            mark(optref);
+            return false;
+        };
+        const char_set &switches = switches_of(m);
+
+        while (!tokens.empty()) {
+            index = tokens.index();
+            token_shape shape = classify(cur);
+            size_t type = shape.type;
+            observer.on_token(cur, static_cast<token_kind>(type));
+
+            auto parse_helper = [&](std::string_view flag, auto optref,
+                                    bool newarg) -> std::expected<bool, error> {
+                if (!optref) {
+                    auto err = fail(
+                        error_kind::unexpected_argument, flag, nullptr, flag);
+                    if (type == LONG && !tokens.failure())
+                        err.error().suggestions = m.suggest(flag.substr(2));
+                    return err;
+                }
+
+                if (optref->need_argument()) {
+                    if (tokens.empty())
+                        return fail(error_kind::missing_value, flag, optref);
+                    if (newarg) {
+                        if (cur.size() > 1 && cur.starts_with('-') &&
+                            !optref->allow_hyphen())
+                            return fail(
+                                error_kind::missing_value, flag, optref);
+                    } else if (cur.starts_with('='))
+                        cur.remove_prefix(1);
+
+                    if (flags.test(index_of(m, optref)))
+                        return fail(error_kind::used_multiple, flag, optref);
+                    // the value is the offending token if it is a new one
+                    if (newarg) index = tokens.index();
+                    std::errc ec = convert(optref, flag, cur);
+                    if (ec != std::errc{})
+                        return fail(
+                            value_error(ec), flag, optref, cur, ec);
+                    mark(optref);
+                    remove_one_arg();
+                    return true;
+                } else {
+                    if (type == LONG && !newarg && cur.starts_with('='))
+                        return fail(
+                            error_kind::unexpected_value, flag, nullptr, cur);
+                    return set_switch(flag, optref);
+                }
+            };
+
+            switch (type) {
+                case SHORT: {
+                    cur.remove_prefix(1);
+                    // leading switches are set without asking what they take,
+                    // the last character also ends the token and goes below
+                    while (cur.size() > 1 && switches.test(cur[0])) {
+                        const char flag[] = {'-', cur[0]};
+                        std::string_view flagview(flag, sizeof(flag));
+                        auto parsed =
+                            set_switch(flagview, find(cur[0], flagview));
+                        if (!parsed) return std::unexpected(parsed.error());
+                        cur.remove_prefix(1);
+                    }
+                    while (true) {
+                        const char flag[] = {'-', cur[0]};
+                        std::string_view flagview(flag, sizeof(flag));
+                        auto result = find(cur[0], flagview);
+                        cur.remove_prefix(1);
+                        if (cur.empty()) {
+                            remove_one_arg();
+                            auto parsed = parse_helper(flagview, result, true);
+                            if (!parsed) return std::unexpected(parsed.error());
+                            break;
+                        }
+                        auto parsed = parse_helper(flagview, result, false);
+                        if (!parsed) return std::unexpected(parsed.error());
+                        if (parsed.value()) break;
+                    };
+                } break;
+                case LONG: {
+                    size_t split_pos = shape.split;
+                    std::expected<bool, error> parsed;
+                    if (split_pos != std::string_view::npos) {
+                        std::string_view flag = cur.substr(0, split_pos);
+                        cur.remove_prefix(split_pos);
+                        parsed = parse_helper(
+                            flag, find(flag.substr(2), flag), false);
+                    } else {
+                        std::string_view flag = cur;
+                        remove_one_arg();
+                        parsed = parse_helper(
+                            flag, find(flag.substr(2), flag), true);
+                    }
+                    if (!parsed) return std::unexpected(parsed.error());
+                } break;
+                case ARGUMENT: {
+                    auto taken = positional(cur);
+                    if (!taken) return std::unexpected(taken.error());
+                    if (taken.value()) {
+                        remove_one_arg();
+                        break;
+                    }
+                    // the first argument left over selects the subcommand,
+                    // which takes all of the remaining tokens
+                    if constexpr (!is_static_meta<MetaT>)
+                        if (auto *commands = commands_of(m)) {
+                            if (auto flushed = flush(); !flushed)
+                                return flushed;
+                            auto dispatched =
+                                commands->command(offset, cur, tokens);
+                            if (!dispatched)
+                                return std::unexpected(
+                                    std::move(dispatched.error()));
+                            if (dispatched.value()) {
+                                mark(commands);
+                                break;
+                            }
+                        }
+                    return fail(
+                        error_kind::unexpected_argument, {}, nullptr, cur);
+                }
+                case ENDARG: {
+                    // the remaining positionals come first
+                    auto tail = tokens.rest();
+                    size_t taken = 0;
+                    for (; taken < tail.size(); ++taken) {
+                        auto parsed = positional(tail[taken]);
+                        if (!parsed) return std::unexpected(parsed.error());
+                        if (!parsed.value()) break;
+                    }
+                    store_ignored(m, offset, tail.subspan(taken));
+                } break;
+                default:
+                    std::unreachable();
+            }
+
+            if (m.help(flags))
+                return fail(error_kind::display_help, {}, nullptr);
+            if (m.version(flags))
+                return fail(error_kind::display_version, {}, nullptr);
+        }
+
+        if (auto flushed = flush(); !flushed) return flushed;
+        if (tokens.failure()) return std::unexpected(*tokens.failure());
+        if constexpr (!is_static_meta<MetaT>) {
+            // values of the lower layers, deferred like the arguments
+            auto set = [&](const anyopt &optref, std::string_view prefix,
+                           std::string_view name, std::string_view value,
+                           size_t token) {
+                if constexpr (deferring_observer<ObserverT>) {
+                    observer.defer(
+                        m.index_of(optref), std::format("{}{}", prefix, name),
+                        value, token, true);
+                    return std::errc{};
+                } else {
+                    return set_setting(optref, offset, value);
+                }
+            };
+            if (given) {
+                auto applied = apply_env(m, flags, *given, set);
+                if (!applied) return applied;
+            }
+            for (const config_file *config : configs) {
+                auto applied = apply_config(m, *config, flags, *given, set);
+                if (!applied) return applied;
+            }
+        }
+        index = tokens.end();
+        stopwatch<ObserverT> watch;
+        std::vector<std::string> missing = missing_opts(m, flags);
+        observer.on_validation(missing.empty(), watch.elapsed());
+        if (missing.size()) {
+            auto err = fail(error_kind::missing_options, {}, nullptr);
+            err.error().missing = std::move(missing);
+            return err;
+        }
+
+        return {};
+    }
+
+    template <typename MetaT>
+    auto parse_stream(
+        const MetaT &m, std::ptrdiff_t offset, token_stream &tokens)
+        -> std::expected<void, error> {
+        null_observer observer;
+        return parse_stream(m, offset, tokens, observer);
+    }
+
+    // Parse `args` with the options of `m`, the options are bound to the
+    // argument group which `m` was generated from and `offset` moves them to
+    // the argument group being filled. Response files are only expanded into
+    // `files`.
+    template <typename MetaT, typename ObserverT = null_observer>
+    auto parse(
+        const MetaT &m, std::ptrdiff_t offset,
+        std::span<const char *const> args, ObserverT &&observer = {},
+        std::span<const config_file *const> configs = {},
+        response_files *files = nullptr) -> std::expected<void, error> {
+        token_stream tokens(args, files);
+        return parse_stream(m, offset, tokens, observer, configs);
+    }
+
+    // The memory resource of a parser, which reports allocations to the
+    // observer before passing them to `upstream`.
+    template <typename ObserverT>
+    class observed_resource : public std::pmr::memory_resource {
+      public:
+        observed_resource(
+            std::pmr::memory_resource *upstream, ObserverT &observer) :
+            _upstream(upstream), _observer(observer) {}
+
+        std::pmr::memory_resource *get() { return this; }
+
+      private:
+        void *do_allocate(size_t bytes, size_t alignment) override {
+            _observer.on_allocation(bytes);
+            return _upstream->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+            _upstream->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(
+            const std::pmr::memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+
+        std::pmr::memory_resource *_upstream;
+        ObserverT &_observer;
+    };
+
+    template <>
+    class observed_resource<null_observer> {
+      public:
+        observed_resource(
+            std::pmr::memory_resource *upstream, null_observer &) :
+            _upstream(upstream) {}
+
+        std::pmr::memory_resource *get() { return _upstream; }
+
+      private:
+        std::pmr::memory_resource *_upstream;
+    };
+
+    // Print the help, version or error message of `err` and exit, the error
+    // is handed down to the subcommand it comes from.
+    template <typename MetaT, typename InfoT>
+    [[noreturn]] void report(
+        const MetaT &m, InfoT &info, const print_helper &printer,
+        std::string_view program_name, const error &err) {
+        if (auto *commands = commands_of(m); commands && !err.commands.empty())
+            commands->report_command(err.commands, program_name, err);
+        printer.report(info, program_name, err);
+    }
+
+    // Append the completions of the last one of `words`, the words after the
+    // program name. Nothing is parsed or validated, tokens before it only
+    // select the subcommand and skip the values of flags.
+    template <typename MetaT>
+    void complete(
+        const MetaT &m, std::span<const char *const> words, string &out) {
+        static constexpr const char *nothing[] = {""};
+        if (words.empty()) words = nothing;
+        std::span<const anyopt *const> positionals = positionals_of(m);
+        size_t slot = 0;
+        for (size_t i = 0; i + 1 < words.size(); ++i) {
+            std::string_view word = words[i];
+            switch (argtype(word)) {
+                case SHORT:
+                    if (word.size() == 2)
+                        if (auto optref = lookup(m, word[1]);
+                            optref && optref->need_argument() &&
+                            ++i + 1 == words.size())
+                            return;  // the value of a flag
+                    break;
+                case LONG:
+                    if (word.find('=') == std::string_view::npos)
+                        if (auto optref = lookup(m, word.substr(2));
+                            optref && optref->need_argument() &&
+                            ++i + 1 == words.size())
+                            return;
+                    break;
+                case ARGUMENT:
+                    if (slot < positionals.size()) {
+                        if (positionals[slot]->opttype != VECTOR) ++slot;
+                    } else if (auto *commands = commands_of(m)) {
+                        if (commands->complete_command(words.subspan(i), out))
+                            return;
+                    }
+                    break;
+                case ENDARG:
+                    return;  // only values follow
+                default:
+                    std::unreachable();
+            }
+        }
+
+        std::string_view partial = words.back();
+        if (partial.starts_with('-')) {
+            m.complete(partial, out);
+        } else if (auto *commands = commands_of(m);
+                   commands && slot == positionals.size()) {
+            for (std::string_view name : commands->command_names())
+                if (name.starts_with(partial)) {
+                    out += name;
+                    out += '\n';
+                }
+        }
+    }
+
+    GREET_INLINE string completion_script(
+        std::string_view shell, std::string_view program_name);
+
+    // Answer `__complete <words>...` and `__completion <shell>` for the
+    // shell completion scripts and exit, return if `args` asks neither.
+    template <typename MetaT>
+    void serve_completion(const MetaT &m, std::span<const char *const> args) {
+        if (args.size() < 2) return;
+        std::string_view mode = args[1];
+        if (mode == "__complete") {
+            string out;
+            complete(m, args.subspan(2), out);
+            write_all(stdout, out);
+            std::exit(0);
+        }
+        if (mode == "__completion") {
+            std::string program = filename(args[0]);
+            string script =
+                completion_script(args.size() > 2 ? args[2] : "", program);
+            if (script.empty()) {
+                write_all(
+                    stderr,
+                    "error: expected one of 'bash', 'zsh' and 'fish' after "
+                    "'__completion'\n");
+                std::exit(2);
+            }
+            write_all(stdout, script);
+            std::exit(0);
+        }
+    }
+}  // namespace _detail
+
+/// A completion script of `shell` ("bash", "zsh" or "fish") for the program
+/// `program_name`, or an empty string for other shells.
+///
+/// The script asks the program itself for candidates with
+/// `<program_name> __complete <words>...`, which `greet::greet()` answers.
+inline std::string completion_script(
+    std::string_view shell, std::string_view program_name) {
+    return std::string(_detail::completion_script(shell, program_name));
+}
+
+namespace _detail {
+#ifdef GREET_DEFINITIONS
+    GREET_INLINE string completion_script(
+        std::string_view shell, std::string_view program_name) {
+        // shell function names only keep the identifier characters
+        string function = "_";
+        for (char c : program_name)
+            function += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+
+        string script;
+        if (shell == "bash")
+            std::format_to(
+                std::back_inserter(script),
+                "{0}() {{\n"
+                "    local IFS=$'\\n'\n"
+                "    COMPREPLY=($({1} __complete "
+                "\"${{COMP_WORDS[@]:1:COMP_CWORD}}\"))\n"
+                "}}\n"
+                "complete -o default -F {0} {1}\n",
+                function,
+                program_name);
+        else if (shell == "zsh")
+            std::format_to(
+                std::back_inserter(script),
+                "#compdef {1}\n"
+                "{0}() {{\n"
+                "    local -a candidates\n"
+                "    candidates=(${{(f)\"$({1} __complete "
+                "\"${{(@)words[2,CURRENT]}}\")\"}})\n"
+                "    if (( ${{#candidates}} )); then\n"
+                "        compadd -a candidates\n"
+                "    else\n"
+                "        _files\n"
+                "    fi\n"
+                "}}\n"
+                "compdef {0} {1}\n",
+                function,
+                program_name);
+        else if (shell == "fish")
+            std::format_to(
+                std::back_inserter(script),
+                "complete -c {0} -a '({0} __complete "
+                "(commandline -opc)[2..-1] (commandline -ct))'\n",
+                program_name);
+        return script;
+    }
+#endif
+}  // namespace _detail
+
+/// A subcommand selected by the first argument, holding the argument group
+/// of the selected one or `std::monostate` if none is selected.
+///
+/// Only the `genmeta()` of the selected argument group is called, and it
+/// parses all of the remaining arguments.
+template <_detail::any_args_group... ArgsGroupTs>
+class subcommands : public std::variant<std::monostate, ArgsGroupTs...> {
+  public:
+    using std::variant<std::monostate, ArgsGroupTs...>::variant;
+
+    explicit operator bool() const;
+};
+
+template <_detail::any_args_group... ArgsGroupTs>
+subcommands<ArgsGroupTs...>::operator bool() const {
+    return this->index() != 0;
+}
+
+namespace _detail {
+    template <typename... ArgsGroupTs>
+    struct opt_type<subcommands<ArgsGroupTs...>> {
+        static constexpr size_t type = COMMAND;
+    };
+
+    template <typename... ArgsGroupTs>
+    class opt_wrapper<subcommands<ArgsGroupTs...>> : public opt_base {
+      public:
+        opt_wrapper(subcommands<ArgsGroupTs...> &optref);
+        opt_wrapper(const opt_wrapper &) = default;
+        opt_wrapper(opt_wrapper &&other);
+        ~opt_wrapper() = default;
+        opt_wrapper &operator=(const opt_wrapper &) = default;
+        opt_wrapper &operator=(opt_wrapper &&other);
+
+        // names of the subcommands, in the order of `ArgsGroupTs`
+        opt_wrapper &names(text_arg_for<ArgsGroupTs>... values) &;
+        opt_wrapper &&names(text_arg_for<ArgsGroupTs>... values) &&;
+        opt_wrapper &required() &;
+        opt_wrapper &&required() &&;
+
+      private:
+        bool get_required() const override;
+        std::errc set(
+            std::ptrdiff_t offset, std::string_view value = {}) const override;
+        void assign(std::ptrdiff_t to, std::ptrdiff_t from) const override;
+        void save(std::ptrdiff_t offset, std::string &out) const override;
+        bool load(std::ptrdiff_t offset, std::string_view &in) const override;
+        std::string_view value_type() const override;
+        auto command(
+            std::ptrdiff_t offset, std::string_view name,
+            token_stream &tokens) const -> std::expected<bool, error> override;
+        auto command_list() const
+            -> vector<std::pair<std::string_view, string>> override;
+        auto command_names() const -> vector<std::string_view> override;
+        void report_command(
+            std::span<const std::string> path, std::string_view program_name,
+            const error &err) const override;
+        bool complete_command(
+            std::span<const char *const> words, string &out) const override;
+
+        template <size_t I>
+        auto _enter(std::ptrdiff_t offset, token_stream &tokens) const
+            -> std::expected<bool, error>;
+        template <size_t I>
+        [[noreturn]] void _report(
+            std::span<const std::string> path, std::string_view program_name,
+            const error &err) const;
+
+        std::reference_wrapper<subcommands<ArgsGroupTs...>> _optref;
+        bool _required;
+        std::array<text, sizeof...(ArgsGroupTs)> _names;
+    };
 
-    template <typename OptT>
-    anyopt::anyopt(opt_wrapper<OptT> &&origin) :
-        opttype(opt_type_v<OptT>),
-        _origin(new opt_wrapper<OptT>(std::move(origin))) {}
+    template <typename... ArgsGroupTs>
+    opt_wrapper<subcommands<ArgsGroupTs...>>::opt_wrapper(
+        subcommands<ArgsGroupTs...> &optref) :
+        opt_base{}, _optref(optref), _required(false), _names{} {}
+
+    template <typename... ArgsGroupTs>
+    opt_wrapper<subcommands<ArgsGroupTs...>>::opt_wrapper(opt_wrapper &&other) :
+        opt_base{std::move(other)},
+        _optref(other._optref),
+        _required(other._required),
+        _names(std::move(other._names)) {}
+
+    template <typename... ArgsGroupTs>
+    auto opt_wrapper<subcommands<ArgsGroupTs...>>::operator=(
+        opt_wrapper &&other) -> opt_wrapper & {
+        opt_base::operator=(std::move(other));
+        _optref = other._optref;
+        _required = other._required;
+        _names = std::move(other._names);
+        return *this;
+    }
 
-    char anyopt::shrt() const { return _origin.get()->get_shrt(); }
+    template <typename... ArgsGroupTs>
+    auto opt_wrapper<subcommands<ArgsGroupTs...>>::names(
+        text_arg_for<ArgsGroupTs>... values) & -> opt_wrapper & {
+        size_t i = 0;
+        (_names[i++].assign(values), ...);
+        return *this;
+    }
+
+    template <typename... ArgsGroupTs>
+    auto opt_wrapper<subcommands<ArgsGroupTs...>>::names(
+        text_arg_for<ArgsGroupTs>... values) && -> opt_wrapper && {
+        names(values...);
+        return std::move(*this);
+    }
 
-    const std::string &anyopt::lng() const { return _origin.get()->get_lng(); }
+    template <typename... ArgsGroupTs>
+    auto opt_wrapper<subcommands<ArgsGroupTs...>>::required() &
+        -> opt_wrapper & {
+        _required = true;
+        return *this;
+    }
 
-    const std::string &anyopt::about() const {
-        return _origin.get()->get_about();
+    template <typename... ArgsGroupTs>
+    auto opt_wrapper<subcommands<ArgsGroupTs...>>::required() &&
+        -> opt_wrapper && {
+        _required = true;
+        return std::move(*this);
     }
 
-    const std::string &anyopt::argname() const {
-        return _origin.get()->get_argname();
+    template <typename... ArgsGroupTs>
+    bool opt_wrapper<subcommands<ArgsGroupTs...>>::get_required() const {
+        return _required;
     }
 
-    bool anyopt::required() const { return _origin.get()->get_required(); }
+    template <typename... ArgsGroupTs>
+    std::errc opt_wrapper<subcommands<ArgsGroupTs...>>::set(
+        std::ptrdiff_t, std::string_view) const {
+        // subcommands are selected by `command()` instead
+        return std::errc::invalid_argument;
+    }
 
-    bool anyopt::allow_hyphen() const {
-        return _origin.get()->get_allow_hyphen();
+    template <typename... ArgsGroupTs>
+    void opt_wrapper<subcommands<ArgsGroupTs...>>::assign(
+        std::ptrdiff_t to, std::ptrdiff_t from) const {
+        rebase(_optref.get(), to) = rebase(_optref.get(), from);
     }
 
-    std::string anyopt::def() const { return _origin.get()->get_def(); }
+    // The selected subcommand is saved as its index, followed by the schema
+    // hash and the values of its argument group.
+    template <typename... ArgsGroupTs>
+    void opt_wrapper<subcommands<ArgsGroupTs...>>::save(
+        std::ptrdiff_t offset, std::string &out) const {
+        auto &selected = rebase(_optref.get(), offset);
+        save_raw<uint64_t>(selected.index(), out);
+        std::visit(
+            [&]<typename ArgsGroupT>(ArgsGroupT &args) {
+                if constexpr (!std::same_as<ArgsGroupT, std::monostate>) {
+                    ArgsGroupT bound{};
+                    auto m = bound.genmeta();
+                    save_raw(schema_hash(m), out);
+                    save_args(m, offset_between(bound, args), out);
+                }
+            },
+            static_cast<
+                std::variant<std::monostate, ArgsGroupTs...> &>(selected));
+    }
 
-    std::errc anyopt::set(const char *value) {
-        return _origin.get()->set(value);
+    template <typename... ArgsGroupTs>
+    bool opt_wrapper<subcommands<ArgsGroupTs...>>::load(
+        std::ptrdiff_t offset, std::string_view &in) const {
+        uint64_t index;
+        if (!load_raw(index, in) || index > sizeof...(ArgsGroupTs))
+            return false;
+        auto &selected = rebase(_optref.get(), offset);
+        if (index == 0) {
+            selected.template emplace<0>();
+            return true;
+        }
+        bool loaded = false;
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (void)((index == I + 1 &&
+                    (loaded = [&] {
+                        auto &args = selected.template emplace<I + 1>();
+                        auto m = args.genmeta();
+                        uint64_t hash;
+                        return load_raw(hash, in) && hash == schema_hash(m) &&
+                               load_args(m, 0, in);
+                    }(),
+                    true)) ||
+                   ...);
+        }(std::index_sequence_for<ArgsGroupTs...>{});
+        return loaded;
     }
 
-    bool anyopt::already_set() const { return _origin.get()->already_set(); }
+    template <typename... ArgsGroupTs>
+    std::string_view
+    opt_wrapper<subcommands<ArgsGroupTs...>>::value_type() const {
+        return type_name<subcommands<ArgsGroupTs...>>();
+    }
 
-    inline bool anyopt::need_argument() const {
-        return _origin.get()->need_argument();
+    template <typename... ArgsGroupTs>
+    auto opt_wrapper<subcommands<ArgsGroupTs...>>::command(
+        std::ptrdiff_t offset, std::string_view name,
+        token_stream &tokens) const -> std::expected<bool, error> {
+        std::expected<bool, error> result = false;
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (void)((_names[I].view() == name &&
+                    (result = _enter<I>(offset, tokens), true)) ||
+                   ...);
+        }(std::index_sequence_for<ArgsGroupTs...>{});
+        return result;
     }
 
-    std::string get_argname(const greet::_detail::anyopt &optref) {
-        if (!optref.argname().empty())
-            return optref.argname();
-        else if (!optref.lng().empty())
-            return uppercase(optref.lng());
-        else
-            return "VALUE";
+    template <typename... ArgsGroupTs>
+    template <size_t I>
+    auto opt_wrapper<subcommands<ArgsGroupTs...>>::_enter(
+        std::ptrdiff_t offset, token_stream &tokens) const
+        -> std::expected<bool, error> {
+        auto &args = rebase(_optref.get(), offset).template emplace<I + 1>();
+        auto m = args.genmeta();
+        tokens.pop();
+        auto parsed = parse_stream(m, 0, tokens);
+        if (!parsed) {
+            error err = std::move(parsed.error());
+            err.commands.emplace(
+                err.commands.begin(), _names[I].view());
+            return std::unexpected(std::move(err));
+        }
+        return true;
+    }
+
+    template <typename... ArgsGroupTs>
+    auto opt_wrapper<subcommands<ArgsGroupTs...>>::command_list() const
+        -> vector<std::pair<std::string_view, string>> {
+        vector<std::pair<std::string_view, string>> result;
+        result.reserve(sizeof...(ArgsGroupTs));
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (result.emplace_back(
+                 _names[I].view(), string(ArgsGroupTs{}.description())),
+             ...);
+        }(std::index_sequence_for<ArgsGroupTs...>{});
+        return result;
+    }
+
+    template <typename... ArgsGroupTs>
+    auto opt_wrapper<subcommands<ArgsGroupTs...>>::command_names() const
+        -> vector<std::string_view> {
+        vector<std::string_view> result;
+        result.reserve(sizeof...(ArgsGroupTs));
+        for (const text &name : _names) result.push_back(name.view());
+        return result;
+    }
+
+    template <typename... ArgsGroupTs>
+    void opt_wrapper<subcommands<ArgsGroupTs...>>::report_command(
+        std::span<const std::string> path, std::string_view program_name,
+        const error &err) const {
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (void)((_names[I].view() == path.front() &&
+                    (_report<I>(path, program_name, err), true)) ||
+                   ...);
+        }(std::index_sequence_for<ArgsGroupTs...>{});
+    }
+
+    template <typename... ArgsGroupTs>
+    bool opt_wrapper<subcommands<ArgsGroupTs...>>::complete_command(
+        std::span<const char *const> words, string &out) const {
+        bool found = false;
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (void)((_names[I].view() == words.front() && (found = true) &&
+                    ([&] {
+                        std::variant_alternative_t<
+                            I + 1, std::variant<std::monostate, ArgsGroupTs...>>
+                            args{};
+                        auto m = args.genmeta();
+                        complete(m, words.subspan(1), out);
+                    }(),
+                    true)) ||
+                   ...);
+        }(std::index_sequence_for<ArgsGroupTs...>{});
+        return found;
+    }
+
+    template <typename... ArgsGroupTs>
+    template <size_t I>
+    [[noreturn]] void opt_wrapper<subcommands<ArgsGroupTs...>>::_report(
+        std::span<const std::string> path, std::string_view program_name,
+        const error &err) const {
+        using ArgsGroupT = std::variant_alternative_t<
+            I + 1, std::variant<std::monostate, ArgsGroupTs...>>;
+        ArgsGroupT args{};
+        auto m = args.genmeta();
+        print_helper printer(describe_opts(m));
+        std::string program = std::format("{} {}", program_name, path.front());
+        error inner = err;
+        inner.commands.erase(inner.commands.begin());
+        report(m, args, printer, program, inner);
     }
 }  // namespace _detail
 
-class meta {
+/// The tokens of a command string, cut out in place by `greet::tokenize()`.
+///
+/// It is a single pass range of null terminated views into the buffer, each
+/// token is only cut when the iterator reaches it.
+class token_range : public std::ranges::view_interface<token_range> {
   public:
-    template <typename... OptionTs>
-    meta(OptionTs &&...options);
-    meta(const meta &) = delete;
-    meta(meta &&) = delete;
+    class iterator {
+      public:
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        std::string_view operator*() const { return *_range->_front; }
+        iterator &operator++();
+        void operator++(int) { ++*this; }
+        bool operator==(std::default_sentinel_t) const {
+            return !_range->_front;
+        }
 
-    auto opts() -> std::vector<_detail::anyopt> &;
-    auto ignored_args() -> std::optional<std::reference_wrapper<ignored>>;
-    auto required_opts()
-        -> const std::vector<std::reference_wrapper<_detail::anyopt>> &;
-    auto query(const std::string &flag)
-        -> std::optional<std::reference_wrapper<_detail::anyopt>>;
-    inline bool help() const;
-    inline bool version() const;
+      private:
+        friend class token_range;
+        explicit iterator(token_range *range) : _range(range) {}
 
-  private:
-    template <typename FirstOptionT, typename... OptionTs>
-    inline void _unpack_opts(FirstOptionT &&first, OptionTs &&...options);
+        token_range *_range = nullptr;
+    };
 
-    bool _help, _version;
-    std::vector<_detail::anyopt> _opts;
-    std::optional<std::reference_wrapper<ignored>> _ignored_args;
-    std::vector<std::reference_wrapper<_detail::anyopt>> _required_opts;
-    std::unordered_map<std::string, std::reference_wrapper<_detail::anyopt>>
-        _sorted_by_flag;
+    token_range(char *begin, char *end);
+
+    iterator begin();
+    std::default_sentinel_t end() const { return {}; }
+
+  private:
+    char *_pos;
+    char *_end;
+    std::optional<std::string_view> _front;
+    bool _started = false;
 };
 
+inline token_range::token_range(char *begin, char *end) :
+    _pos(begin), _end(end) {}
+
+inline token_range::iterator token_range::begin() {
+    if (!std::exchange(_started, true))
+        _front = _detail::next_token(_pos, _end);
+    return iterator(this);
+}
+
+inline token_range::iterator &token_range::iterator::operator++() {
+    _range->_front = _detail::next_token(_range->_pos, _range->_end);
+    return *this;
+}
+
+/// Split `command` in place into tokens like response files: whitespace
+/// separates tokens, and quotes and backslash escapes are resolved.
+inline token_range tokenize(std::string &command) {
+    return token_range(command.data(), command.data() + command.size());
+}
+
+/// Split `command` into tokens like the overload above, the unescaped tokens
+/// are written into `buffer`, which may be reused for the next command.
+inline token_range tokenize(std::string_view command, std::string &buffer) {
+    buffer.assign(command);
+    return tokenize(buffer);
+}
+
 namespace _detail {
-    class print_helper {
+    template <typename RangeT>
+    concept token_views =
+        std::ranges::input_range<RangeT> &&
+        std::convertible_to<std::ranges::range_reference_t<RangeT>,
+                            std::string_view>;
+
+    // The argument list of a range of tokens, the tokens of a
+    // `greet::token_range` are null terminated already, others are copied
+    // into `_storage`.
+    class token_args {
       public:
-        print_helper(std::string &&program_name, meta &m);
-        print_helper(const print_helper &) = delete;
-        print_helper(print_helper &&) = delete;
+        template <token_views RangeT>
+        explicit token_args(RangeT &&tokens);
 
-        void print_usage() const;
-        void print_options() const;
-        [[noreturn]] static void internal_error(const std::string &msg);
-        [[noreturn]] void unexpected_argument(const std::string &arg) const;
-        [[noreturn]] void missing_value(
-            const std::string &flag, const anyopt &optref) const;
-        [[noreturn]] void unexpected_value(
-            const std::string &flag, const std::string &value) const;
-        [[noreturn]] void invalid_value(
-            const std::string &flag, const std::string &value,
-            const anyopt &optref, std::errc ec) const;
-        [[noreturn]] void used_mutiple(
-            const std::string &flag, const anyopt &optref) const;
-        [[noreturn]] void missing_options(
-            const std::vector<std::reference_wrapper<_detail::anyopt>> &opts)
-            const;
+        std::span<const char *const> args() const { return _args; }
 
       private:
-        std::string _program_name;
-        meta &_metaref;
+        string _storage;
+        vector<const char *> _args;
     };
 
-    print_helper::print_helper(std::string &&program_name, meta &m) :
-        _program_name(std::move(program_name)), _metaref(m) {}
-
-    void print_helper::print_usage() const {
-        std::cout << "Usage: " << _program_name << " [OPTIONS]";
-        for (const auto &optref : _metaref.required_opts()) {
-            if (optref.get().lng().empty())
-                std::cout << std::format(
-                    " -{} <{}>",
-                    optref.get().shrt(),
-                    get_argname(optref.get()));
-            else
-                std::cout << std::format(
-                    " --{} <{}>",
-                    optref.get().lng(),
-                    get_argname(optref.get()));
-        }
-        std::cout << std::endl;
+    // `greet::try_greet()` and `greet::greet()` in the current resource.
+    template <typename ArgsGroupT>
+    auto try_greet_span(
+        std::span<const char *const> args,
+        std::span<const config_file *const> configs = {},
+        response_files *files = nullptr) -> std::expected<ArgsGroupT, error> {
+        ArgsGroupT result{};
+        auto m = result.genmeta();
+        auto parsed = parse(m, 0, args, null_observer{}, configs, files);
+        if (!parsed) return std::unexpected(std::move(parsed.error()));
+        return result;
     }
 
-    void print_helper::print_options() const {
-        std::cout << "Options:" << std::endl;
-
-        size_t fixed_width = 0;
-        for (const auto &optref : _metaref.opts()) {
-            size_t width = 8;
-            if (!optref.lng().empty()) width += 2 + optref.lng().size();
-            if (optref.need_argument()) width += 3 + get_argname(optref).size();
-            fixed_width = std::max(fixed_width, width);
-        }
+    template <typename ArgsGroupT>
+    ArgsGroupT greet_span(
+        std::span<const char *const> args,
+        std::span<const config_file *const> configs = {},
+        response_files *files = nullptr) {
+        ArgsGroupT result{};
+        auto m = result.genmeta();
+        serve_completion(m, args);
+        auto parsed = parse(m, 0, args, null_observer{}, configs, files);
+        if (!parsed)
+            report(
+                m,
+                result,
+                print_helper(describe_opts(m)),
+                filename(args.empty() ? "" : args.front()),
+                parsed.error());
+        return result;
+    }
 
-        for (const auto &optref : _metaref.opts()) {
-            std::string item = "  ";
-            if (optref.shrt() == '\0')
-                item += "   ";
-            else if (optref.lng().empty())
-                item += std::format("-{}", optref.shrt());
-            else
-                item += std::format("-{},", optref.shrt());
-
-            if (!optref.lng().empty())
-                item += std::format(" --{}", optref.lng());
-
-            if (optref.need_argument())
-                item += std::format(" <{}>", get_argname(optref));
-            item.resize(fixed_width, ' ');
-            std::cout << item << optref.about();
-            if (optref.opttype == NORMAL) {
-                if (optref.required())
-                    std::cout << " [REQUIRED]";
-                else
-                    std::cout << std::format(" [default: {}]", optref.def());
+    template <token_views RangeT>
+    token_args::token_args(RangeT &&tokens) {
+        if constexpr (std::same_as<std::remove_cvref_t<RangeT>, token_range>) {
+            for (std::string_view token : tokens)
+                _args.push_back(token.data());
+        } else {
+            vector<size_t> offsets;
+            for (std::string_view token : tokens) {
+                offsets.push_back(_storage.size());
+                _storage.append(token);
+                _storage.push_back('\0');
             }
-            std::cout << std::endl;
+            for (size_t offset : offsets)
+                _args.push_back(_storage.data() + offset);
         }
     }
+}  // namespace _detail
 
-    [[noreturn]] void print_helper::internal_error(const std::string &msg) {
-        std::cerr << "[internal error]: " << msg << std::endl;
-        std::exit(1);
-    }
+/// Parse the arguments like `greet()`, but return the error instead of
+/// printing it and exiting, `-h` and `-V` are also reported as errors.
+template <_detail::any_args_group ArgsGroupT>
+auto try_greet(
+    int argc, char *argv[], std::pmr::memory_resource *resource)
+    -> std::expected<ArgsGroupT, error> {
+    _detail::resource_scope scope(resource);
+    return _detail::try_greet_span<ArgsGroupT>(
+        std::span<const char *const>(argv, argc));
+}
 
-    [[noreturn]] void print_helper::unexpected_argument(
-        const std::string &arg) const {
-        std::cerr << std::format("error: unexpected argument '{}' found", arg)
-                  << std::endl;
-        std::cout << std::endl;
-        print_usage();
-        std::cout << std::endl;
-        std::cout << "For more information, try '--help'." << std::endl;
-        std::exit(2);
-    }
+template <_detail::any_args_group ArgsGroupT>
+auto try_greet(int argc, char *argv[]) -> std::expected<ArgsGroupT, error> {
+    arena<> session;
+    return try_greet<ArgsGroupT>(argc, argv, &session);
+}
 
-    [[noreturn]] void print_helper::missing_value(
-        const std::string &flag, const anyopt &optref) const {
-        std::cerr << std::format(
-                         "error: a value is required for '{} <{}>' but "
-                         "none was supplied",
-                         flag,
-                         get_argname(optref))
-                  << std::endl;
-        std::cout << std::endl;
-        print_usage();
-        std::cout << std::endl;
-        std::cout << "For more information, try '--help'." << std::endl;
-        std::exit(2);
-    }
+/// Parse the arguments like `try_greet()`, and expand `@path` tokens into
+/// `files`.
+template <_detail::any_args_group ArgsGroupT>
+auto try_greet(int argc, char *argv[], response_files &files)
+    -> std::expected<ArgsGroupT, error> {
+    arena<> session;
+    _detail::resource_scope scope(&session);
+    return _detail::try_greet_span<ArgsGroupT>(
+        std::span<const char *const>(argv, argc), {}, &files);
+}
 
-    [[noreturn]] void print_helper::unexpected_value(
-        const std::string &flag, const std::string &value) const {
-        std::cerr << std::format(
-                         "error: unexpected value '{}' for '{}' found; no more "
-                         "were expected",
-                         value,
-                         flag)
-                  << std::endl;
-        std::cout << std::endl;
-        print_usage();
-        std::cout << std::endl;
-        std::cout << "For more information, try '--help'." << std::endl;
-        std::exit(2);
-    }
+/// Parse the arguments like `try_greet()`, options not given in them are
+/// taken from `config`.
+template <args_group ArgsGroupT>
+auto try_greet(int argc, char *argv[], const config_file &config)
+    -> std::expected<ArgsGroupT, error> {
+    arena<> session;
+    _detail::resource_scope scope(&session);
+    const config_file *configs[] = {&config};
+    return _detail::try_greet_span<ArgsGroupT>(
+        std::span<const char *const>(argv, argc), configs);
+}
 
-    [[noreturn]] void print_helper::invalid_value(
-        const std::string &flag, const std::string &value, const anyopt &optref,
-        std::errc ec) const {
-        std::cerr << std::format(
-                         "error: invalid value '{}' for '{} <{}>': {}",
-                         value,
-                         flag,
-                         get_argname(optref),
-                         std::make_error_code(ec).message())
-                  << std::endl;
-        std::cout << std::endl;
-        print_usage();
-        std::cout << std::endl;
-        std::cout << "For more information, try '--help'." << std::endl;
-        std::exit(2);
-    }
+/// Parse a range of tokens like `try_greet()`, the first token is the program
+/// name. The tokens of `greet::tokenize()` are used in place, others are
+/// copied and only live during the call, so options must not keep views
+/// into them, such as `greet::ignored_view` and `const char *`.
+template <_detail::any_args_group ArgsGroupT, _detail::token_views RangeT>
+auto try_greet(RangeT &&tokens) -> std::expected<ArgsGroupT, error> {
+    arena<> session;
+    _detail::resource_scope scope(&session);
+    _detail::token_args args(std::forward<RangeT>(tokens));
+    return _detail::try_greet_span<ArgsGroupT>(args.args());
+}
 
-    [[noreturn]] void print_helper::used_mutiple(
-        const std::string &flag, const anyopt &optref) const {
-        if (optref.need_argument())
-            std::cerr << std::format(
-                             "error: the argument '{} <{}>' cannot be used "
-                             "multiple times",
-                             flag,
-                             get_argname(optref))
-                      << std::endl;
-        else
-            std::cerr << std::format(
-                             "error: the argument '{}' cannot be used "
-                             "multiple times",
-                             flag)
-                      << std::endl;
-        std::cout << std::endl;
-        print_usage();
-        std::cout << std::endl;
-        std::cout << "For more information, try '--help'." << std::endl;
-        std::exit(2);
-    }
+/// Parse the arguments, all allocations of the schema, the parsing and the
+/// help message come from `resource`.
+template <_detail::any_args_group ArgsGroupT>
+ArgsGroupT greet(int argc, char *argv[], std::pmr::memory_resource *resource) {
+    _detail::resource_scope scope(resource);
+    return _detail::greet_span<ArgsGroupT>(
+        std::span<const char *const>(argv, argc));
+}
 
-    [[noreturn]] void print_helper::missing_options(
-        const std::vector<std::reference_wrapper<_detail::anyopt>> &opts)
-        const {
-        std::cerr
-            << "error: the following required arguments were not provided:"
-            << std::endl;
-        for (const auto &optref : opts)
-            if (optref.get().lng().empty())
-                std::cout << std::format(
-                                 "  -{} <{}>",
-                                 optref.get().shrt(),
-                                 get_argname(optref.get()))
-                          << std::endl;
-            else
-                std::cout << std::format(
-                                 "  --{} <{}>",
-                                 optref.get().lng(),
-                                 get_argname(optref.get()))
-                          << std::endl;
-
-        std::cout << std::endl;
-        print_usage();
-        std::cout << std::endl;
-        std::cout << "For more information, try '--help'." << std::endl;
-        std::exit(2);
-    }
-}  // namespace _detail
+/// Parse the arguments with a `greet::arena` on the stack.
+template <_detail::any_args_group ArgsGroupT>
+ArgsGroupT greet(int argc, char *argv[]) {
+    arena<> session;
+    return greet<ArgsGroupT>(argc, argv, &session);
+}
 
-template <typename OptT>
-auto opt(OptT &optref) {
-    if constexpr (std::is_same_v<std::decay_t<OptT>, ignored>)
-        return std::ref(optref);
-    else
-        return _detail::opt_wrapper<OptT>(optref);
-};
+/// Parse the arguments, and expand `@path` tokens into `files`.
+template <_detail::any_args_group ArgsGroupT>
+ArgsGroupT greet(int argc, char *argv[], response_files &files) {
+    arena<> session;
+    _detail::resource_scope scope(&session);
+    return _detail::greet_span<ArgsGroupT>(
+        std::span<const char *const>(argv, argc), {}, &files);
+}
 
-counter::counter() : _counter{0} {}
+/// Parse the arguments, options not given in them are taken from `config`.
+template <args_group ArgsGroupT>
+ArgsGroupT greet(int argc, char *argv[], const config_file &config) {
+    arena<> session;
+    _detail::resource_scope scope(&session);
+    const config_file *configs[] = {&config};
+    return _detail::greet_span<ArgsGroupT>(
+        std::span<const char *const>(argv, argc), configs);
+}
 
-counter::counter(counter &&other) {
-    _counter = other._counter;
-    other._counter = 0;
+/// Parse a range of tokens, see `try_greet()` for the lifetime of tokens.
+template <_detail::any_args_group ArgsGroupT, _detail::token_views RangeT>
+ArgsGroupT greet(RangeT &&tokens) {
+    arena<> session;
+    _detail::resource_scope scope(&session);
+    _detail::token_args args(std::forward<RangeT>(tokens));
+    return _detail::greet_span<ArgsGroupT>(args.args());
 }
 
-counter &counter::operator=(counter &&other) {
-    _counter = other._counter;
-    other._counter = 0;
-    return *this;
+/// A precompiled parser, which calls `genmeta()` and builds the flag tables
+/// only once and then parses as many argument lists as you want.
+///
+/// The options must be bound to the members of `ArgsGroupT`, each argument
+/// group returned by `parse()` is a copy of the one holding default values.
+/// The schema and everything allocated while parsing come from `resource`,
+/// which must outlive the parser.
+///
+/// The parser reports its events to an `ObserverT`, such as
+/// `greet::parse_stats`, which must be safe to call from every thread that
+/// parses with it. The default `greet::null_observer` costs nothing.
+template <
+    _detail::any_args_group ArgsGroupT,
+    parse_observer ObserverT = null_observer>
+    requires std::copy_constructible<ArgsGroupT>
+class parser {
+  public:
+    explicit parser(
+        std::pmr::memory_resource *resource = std::pmr::new_delete_resource());
+    parser(const parser &) = delete;
+    parser(parser &&) = delete;
+
+    auto try_parse(std::span<const char *const> args) const
+        -> std::expected<ArgsGroupT, error>;
+    ArgsGroupT parse(std::span<const char *const> args) const;
+    ArgsGroupT parse(int argc, char *argv[]) const;
+    // `@path` tokens in `args` are expanded into `files`
+    auto try_parse(
+        std::span<const char *const> args, response_files &files) const
+        -> std::expected<ArgsGroupT, error>;
+    ArgsGroupT parse(
+        std::span<const char *const> args, response_files &files) const;
+    // options not given in `args` are taken from `config`
+    auto try_parse(
+        std::span<const char *const> args, const config_file &config) const
+        -> std::expected<ArgsGroupT, error>
+        requires args_group<ArgsGroupT>;
+    ArgsGroupT parse(
+        std::span<const char *const> args, const config_file &config) const
+        requires args_group<ArgsGroupT>;
+
+    /// The help renderer, the option table is rendered on the first call
+    /// and cached for the lifetime of the parser.
+    const _detail::print_helper &printer() const;
+
+    ObserverT &observer() const { return _observer; }
+
+  private:
+    auto _try_parse(
+        std::span<const char *const> args,
+        std::span<const config_file *const> configs,
+        response_files *files = nullptr) const
+        -> std::expected<ArgsGroupT, error>;
+    ArgsGroupT _parse(
+        std::span<const char *const> args,
+        std::span<const config_file *const> configs,
+        response_files *files = nullptr) const;
+
+    [[no_unique_address]] mutable ObserverT _observer;
+    mutable _detail::observed_resource<ObserverT> _resource;
+    // started before `genmeta()` to time the schema
+    [[no_unique_address]] _detail::stopwatch<ObserverT> _built;
+    // only written by `genmeta()` while constructing
+    ArgsGroupT _defaults;
+    const decltype(std::declval<ArgsGroupT &>().genmeta()) _meta;
+    mutable std::once_flag _printer_once;
+    mutable std::optional<_detail::print_helper> _printer;
 };
 
-counter &counter::operator++() {
-    ++_counter;
-    return *this;
+template <_detail::any_args_group ArgsGroupT, parse_observer ObserverT>
+    requires std::copy_constructible<ArgsGroupT>
+parser<ArgsGroupT, ObserverT>::parser(std::pmr::memory_resource *resource) :
+    _observer{},
+    _resource(resource, _observer),
+    _built{},
+    _defaults{},
+    _meta(_detail::with_resource(_resource.get(), [this] {
+        return _defaults.genmeta();
+    })) {
+    _observer.on_schema(_built.elapsed());
 }
 
-counter counter::operator++(int) {
-    counter prev = *this;
-    ++_counter;
-    return prev;
+template <_detail::any_args_group ArgsGroupT, parse_observer ObserverT>
+    requires std::copy_constructible<ArgsGroupT>
+auto parser<ArgsGroupT, ObserverT>::try_parse(
+    std::span<const char *const> args) const
+    -> std::expected<ArgsGroupT, error> {
+    return _try_parse(args, {});
 }
 
-counter::operator size_t() { return _counter; }
+template <_detail::any_args_group ArgsGroupT, parse_observer ObserverT>
+    requires std::copy_constructible<ArgsGroupT>
+ArgsGroupT parser<ArgsGroupT, ObserverT>::parse(
+    std::span<const char *const> args) const {
+    return _parse(args, {});
+}
 
-template <typename... OptionTs>
-meta::meta(OptionTs &&...options) :
-    _help{false},
-    _version{false},
-    _opts{},
-    _ignored_args(std::nullopt),
-    _required_opts{},
-    _sorted_by_flag{} {
-    constexpr size_t ignored_opt_nums = _detail::
-        type_positions_t<std::reference_wrapper<ignored>, OptionTs...>::size();
-    static_assert(
-        ignored_opt_nums <= 1,
-        "can only provide 0 or 1 `greet::ignored` option!");
+template <_detail::any_args_group ArgsGroupT, parse_observer ObserverT>
+    requires std::copy_constructible<ArgsGroupT>
+auto parser<ArgsGroupT, ObserverT>::try_parse(
+    std::span<const char *const> args, response_files &files) const
+    -> std::expected<ArgsGroupT, error> {
+    return _try_parse(args, {}, &files);
+}
 
-    _opts.reserve(sizeof...(OptionTs) + 2 - ignored_opt_nums);
-    _unpack_opts(std::forward<OptionTs>(options)...);
+template <_detail::any_args_group ArgsGroupT, parse_observer ObserverT>
+    requires std::copy_constructible<ArgsGroupT>
+ArgsGroupT parser<ArgsGroupT, ObserverT>::parse(
+    std::span<const char *const> args, response_files &files) const {
+    return _parse(args, {}, &files);
+}
 
-    _opts.emplace_back(
-        _detail::anyopt(opt(_help).shrt('h').lng("help").about("Print help")));
-    _opts.emplace_back(_detail::anyopt(
-        opt(_version).shrt('V').lng("version").about("Print version")));
+template <_detail::any_args_group ArgsGroupT, parse_observer ObserverT>
+    requires std::copy_constructible<ArgsGroupT>
+auto parser<ArgsGroupT, ObserverT>::try_parse(
+    std::span<const char *const> args, const config_file &config) const
+    -> std::expected<ArgsGroupT, error>
+    requires args_group<ArgsGroupT>
+{
+    const config_file *configs[] = {&config};
+    return _try_parse(args, configs);
+}
 
-    _sorted_by_flag.reserve(sizeof...(OptionTs) * 2);
+template <_detail::any_args_group ArgsGroupT, parse_observer ObserverT>
+    requires std::copy_constructible<ArgsGroupT>
+ArgsGroupT parser<ArgsGroupT, ObserverT>::parse(
+    std::span<const char *const> args, const config_file &config) const
+    requires args_group<ArgsGroupT>
+{
+    const config_file *configs[] = {&config};
+    return _parse(args, configs);
+}
 
-    for (auto &optref : _opts) {
-        if (optref.shrt() == '\0' && optref.lng().empty())
-            _detail::print_helper::internal_error(
-                "there is an option that specifies neither short nor long "
-                "flags.");
+template <_detail::any_args_group ArgsGroupT, parse_observer ObserverT>
+    requires std::copy_constructible<ArgsGroupT>
+auto parser<ArgsGroupT, ObserverT>::_try_parse(
+    std::span<const char *const> args,
+    std::span<const config_file *const> configs, response_files *files) const
+    -> std::expected<ArgsGroupT, error> {
+    _detail::resource_scope scope(_resource.get());
+    _detail::stopwatch<ObserverT> watch;
+    ArgsGroupT result = _defaults;
+    auto parsed = _detail::parse(
+        _meta,
+        _detail::offset_between(_defaults, result),
+        args,
+        _observer,
+        configs,
+        files);
+    _observer.on_parse(parsed.has_value(), watch.elapsed());
+    if (!parsed) return std::unexpected(std::move(parsed.error()));
+    return result;
+}
 
-        bool inserted;
-        if (optref.shrt() != '\0') {
-            if (optref.shrt() < '!' || optref.shrt() > '~')
-                _detail::print_helper::internal_error(
-                    "the short flag must be a printable character.");
-            if (optref.shrt() == '-')
-                _detail::print_helper::internal_error(
-                    "the short flag cannot be '-'.");
+template <_detail::any_args_group ArgsGroupT, parse_observer ObserverT>
+    requires std::copy_constructible<ArgsGroupT>
+ArgsGroupT parser<ArgsGroupT, ObserverT>::_parse(
+    std::span<const char *const> args,
+    std::span<const config_file *const> configs, response_files *files) const {
+    {
+        _detail::resource_scope scope(_resource.get());
+        _detail::serve_completion(_meta, args);
+    }
+    auto result = _try_parse(args, configs, files);
+    if (!result) {
+        _detail::resource_scope scope(_resource.get());
+        // `description()` and `version()` are not const
+        ArgsGroupT info = _defaults;
+        _detail::report(
+            _meta,
+            info,
+            printer(),
+            _detail::filename(args.empty() ? "" : args[0]),
+            result.error());
+    }
+    return std::move(result.value());
+}
 
-            std::tie(std::ignore, inserted) = _sorted_by_flag.emplace(
-                std::string("-") + optref.shrt(), std::ref(optref));
-            if (!inserted)
-                _detail::print_helper::internal_error(std::format(
-                    "the flag '-{}' is already be used.", optref.shrt()));
+template <_detail::any_args_group ArgsGroupT, parse_observer ObserverT>
+    requires std::copy_constructible<ArgsGroupT>
+const _detail::print_helper &parser<ArgsGroupT, ObserverT>::printer() const {
+    std::call_once(_printer_once, [this] {
+        _detail::resource_scope scope(_resource.get());
+        _printer.emplace(_detail::describe_opts(_meta));
+    });
+    return *_printer;
+}
+
+template <_detail::any_args_group ArgsGroupT, parse_observer ObserverT>
+    requires std::copy_constructible<ArgsGroupT>
+ArgsGroupT parser<ArgsGroupT, ObserverT>::parse(int argc, char *argv[]) const {
+    return parse(std::span<const char *const>(argv, argc));
+}
+
+namespace _detail {
+    // Parse the lines of `lines` one by one, each line is copied into a
+    // scratch buffer that is tokenized in place.
+    template <typename ArgsGroupT>
+    void parse_lines(
+        const parser<ArgsGroupT> &schema, std::string_view lines,
+        std::vector<std::expected<ArgsGroupT, error>> &results) {
+        std::string scratch;
+        // the program name is not a part of a line
+        std::vector<const char *> argv{""};
+        while (!lines.empty()) {
+            size_t eol = lines.find('\n');
+            std::string_view line = lines.substr(0, eol);
+            lines.remove_prefix(
+                eol == std::string_view::npos ? lines.size() : eol + 1);
+            if (line.ends_with('\r')) line.remove_suffix(1);
+
+            argv.resize(1);
+            for (std::string_view token : tokenize(line, scratch))
+                argv.push_back(token.data());
+            results.push_back(schema.try_parse(argv));
         }
-        if (!optref.lng().empty()) {
-            std::tie(std::ignore, inserted) = _sorted_by_flag.emplace(
-                std::string("--") + optref.lng(), std::ref(optref));
-            if (!inserted)
-                _detail::print_helper::internal_error(std::format(
-                    "the flag '--{}' is already be used.", optref.lng()));
+    }
+}  // namespace _detail
+
+/// Parse a buffer holding one argument list per line, without the program
+/// name, and return the result of each line in order.
+///
+/// Lines are tokenized like response files and split into at most `threads`
+/// ranges, which are parsed concurrently with one shared `greet::parser`.
+/// Tokens only live while their line is parsed, so options must not keep
+/// views into them, such as `greet::ignored_view` and `const char *`.
+template <_detail::any_args_group ArgsGroupT>
+    requires std::copy_constructible<ArgsGroupT>
+auto parse_batch(
+    std::string_view buffer,
+    size_t threads = std::thread::hardware_concurrency())
+    -> std::vector<std::expected<ArgsGroupT, error>> {
+    const parser<ArgsGroupT> schema;
+    // small buffers are not worth a thread
+    constexpr size_t min_range = 64 * 1024;
+    threads = std::clamp<size_t>(
+        std::min(threads, buffer.size() / min_range), 1, 256);
+
+    // split at the line ends following equally sized byte ranges
+    std::vector<std::string_view> ranges;
+    while (!buffer.empty()) {
+        size_t size = buffer.size() / (threads - ranges.size());
+        size_t eol = ranges.size() + 1 == threads
+                         ? std::string_view::npos
+                         : buffer.find('\n', size ? size - 1 : 0);
+        size_t end = eol == std::string_view::npos ? buffer.size() : eol + 1;
+        ranges.push_back(buffer.substr(0, end));
+        buffer.remove_prefix(end);
+    }
+
+    std::vector<std::vector<std::expected<ArgsGroupT, error>>> parts(
+        ranges.size());
+    {
+        std::vector<std::jthread> workers;
+        for (size_t i = 1; i < ranges.size(); ++i)
+            workers.emplace_back([&, i] {
+                _detail::parse_lines(schema, ranges[i], parts[i]);
+            });
+        if (!ranges.empty())
+            _detail::parse_lines(schema, ranges.front(), parts.front());
+    }
+
+    std::vector<std::expected<ArgsGroupT, error>> results;
+    size_t total = 0;
+    for (const auto &part : parts) total += part.size();
+    results.reserve(total);
+    for (auto &part : parts)
+        std::move(part.begin(), part.end(), std::back_inserter(results));
+    return results;
+}
+
+namespace _detail {
+    // "greet" and the version of the snapshot format
+    inline constexpr std::string_view snapshot_magic("greet\0\0\1", 8);
+}  // namespace _detail
+
+/// Save the values of parsed arguments into a binary snapshot, which
+/// `greet::load()` reads back without tokenizing and converting.
+///
+/// Snapshots are meant for processes of the same build: numbers are stored in
+/// the native byte order, and the schema hash only covers flags and option
+/// types. `greet::ignored_view` options are not saved.
+template <args_group ArgsGroupT>
+std::string save(const ArgsGroupT &args) {
+    ArgsGroupT bound{};
+    meta m = bound.genmeta();
+    std::string out(_detail::snapshot_magic);
+    _detail::save_raw(_detail::schema_hash(m), out);
+    _detail::save_args(m, _detail::offset_between(bound, args), out);
+    return out;
+}
+
+/// Load arguments saved by `greet::save()`, nothing if the snapshot is
+/// malformed or from another schema. `const char *` and `std::string_view`
+/// options refer to `snapshot`, which must outlive them.
+template <args_group ArgsGroupT>
+std::optional<ArgsGroupT> load(std::string_view snapshot) {
+    if (!snapshot.starts_with(_detail::snapshot_magic)) return std::nullopt;
+    snapshot.remove_prefix(_detail::snapshot_magic.size());
+
+    std::optional<ArgsGroupT> args(std::in_place);
+    meta m = args->genmeta();
+    uint64_t hash;
+    if (!_detail::load_raw(hash, snapshot) || hash != _detail::schema_hash(m) ||
+        !_detail::load_args(m, 0, snapshot) || !snapshot.empty())
+        return std::nullopt;
+    return args;
+}
+
+/// Load arguments from `snapshot` if it fits the schema, otherwise parse the
+/// arguments with `greet()`.
+template <args_group ArgsGroupT>
+ArgsGroupT load_or_greet(std::string_view snapshot, int argc, char *argv[]) {
+    if (auto args = load<ArgsGroupT>(snapshot)) return std::move(*args);
+    return greet<ArgsGroupT>(argc, argv);
+}
+
+namespace _detail {
+    // Takes the values of a parse for `greet::reloader`, which converts them
+    // only if they changed.
+    struct value_recorder : null_observer {
+        struct value {
+            std::string text;
+            std::string flag;
+            size_t token;
+            // from the environment or a config file, see `set_setting()`
+            bool setting;
+        };
+
+        explicit value_recorder(size_t options) : values(options) {}
+
+        void defer(
+            size_t option, std::string_view flag, std::string_view text,
+            size_t token, bool setting) {
+            values[option].push_back(
+                value{std::string(text), std::string(flag), token, setting});
         }
 
-        if (optref.required()) _required_opts.emplace_back(std::ref(optref));
+        // indexed by the position of the option in `greet::meta::opts()`
+        std::vector<std::vector<value>> values;
     };
-}
 
-auto meta::opts() -> std::vector<_detail::anyopt> & { return _opts; }
+    inline std::atomic<unsigned> sighups = 0;
+
+    GREET_INLINE void count_sighup(int);
+
+    // the content of the file at `path`, empty if it cannot be read
+    inline std::string read_file(const std::string &path) {
+        std::string content;
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        if (!file) return content;
+        char buffer[4096];
+        size_t count;
+        while ((count = std::fread(buffer, 1, sizeof(buffer), file)))
+            content.append(buffer, count);
+        std::fclose(file);
+        return content;
+    }
+}  // namespace _detail
 
-auto meta::ignored_args() -> std::optional<std::reference_wrapper<ignored>> {
-    return _ignored_args;
+/// Let `greet::reloader::poll()` reload after the process got a SIGHUP.
+GREET_INLINE void reload_on_sighup();
+
+#ifdef GREET_DEFINITIONS
+GREET_INLINE void _detail::count_sighup(int) {
+    _detail::sighups.fetch_add(1, std::memory_order_relaxed);
 }
 
-auto meta::required_opts()
-    -> const std::vector<std::reference_wrapper<_detail::anyopt>> & {
-    return _required_opts;
+GREET_INLINE void reload_on_sighup() {
+#ifdef SIGHUP
+    std::signal(SIGHUP, _detail::count_sighup);
+#endif
 }
+#endif
 
-auto meta::query(const std::string &flag)
-    -> std::optional<std::reference_wrapper<_detail::anyopt>> {
-    if (_sorted_by_flag.contains(flag))
-        return _sorted_by_flag.at(flag);
-    else
-        return std::nullopt;
-};
+/// Arguments from the command line and an options file, which can be
+/// reloaded while other threads read them.
+///
+/// The tokens of the options file come before the arguments after the
+/// program name. A reload parses all tokens again, but only converts the
+/// options whose values changed, the others keep their values. The result
+/// is published as an immutable snapshot, so readers never wait for a
+/// reload. Options viewing their values, such as `std::string_view`, view
+/// copies which live as long as every snapshot holding the value.
+/// Subcommands are always converted again.
+template <args_group ArgsGroupT>
+    requires std::copy_constructible<ArgsGroupT>
+class reloader {
+  public:
+    /// `args` is the argument list of `main()`, which must outlive it.
+    reloader(std::span<const char *const> args, std::string path);
+    reloader(const reloader &) = delete;
+    reloader(reloader &&) = delete;
+
+    /// Read the options file and parse everything again, return how many
+    /// options were converted. The snapshot is kept if it fails.
+    auto reload() -> std::expected<size_t, error>;
+    /// Reload if the process got a SIGHUP since the last poll, see
+    /// `greet::reload_on_sighup()`.
+    auto poll() -> std::expected<bool, error>;
+    /// The latest arguments, the default values before the first reload.
+    std::shared_ptr<const ArgsGroupT> snapshot() const;
 
-inline bool meta::help() const { return _help; }
+  private:
+    // the values recorded for one option, which the converted value may
+    // view, shared by the snapshots in which the option did not change
+    using recorded =
+        std::shared_ptr<const std::vector<_detail::value_recorder::value>>;
+
+    // the arguments and everything they may refer to
+    struct state {
+        ArgsGroupT args;
+        std::string file;
+        std::vector<const char *> tokens;
+        std::vector<recorded> values;
+    };
 
-inline bool meta::version() const { return _version; }
+    auto _reload() -> std::expected<size_t, error>;
+
+    std::span<const char *const> _args;
+    std::string _path;
+    // only written by `genmeta()` while constructing
+    ArgsGroupT _defaults;
+    const meta _meta;
+    // serializes reloads
+    std::mutex _mutex;
+    std::vector<recorded> _values;
+    unsigned _sighups;
+    std::atomic<std::shared_ptr<const ArgsGroupT>> _snapshot;
+};
 
-template <typename FirstOptionT, typename... OptionTs>
-inline void meta::_unpack_opts(FirstOptionT &&first, OptionTs &&...options) {
-    if constexpr (std::is_same_v<
-                      std::decay_t<FirstOptionT>,
-                      std::reference_wrapper<ignored>>)
-        _ignored_args = first;
-    else
-        _opts.emplace_back(_detail::anyopt(std::forward<FirstOptionT>(first)));
+template <args_group ArgsGroupT>
+    requires std::copy_constructible<ArgsGroupT>
+reloader<ArgsGroupT>::reloader(
+    std::span<const char *const> args, std::string path) :
+    _args(args),
+    _path(std::move(path)),
+    _defaults{},
+    _meta(_defaults.genmeta()),
+    _values(
+        _meta.opts().size(),
+        std::make_shared<
+            const std::vector<_detail::value_recorder::value>>()),
+    _sighups(_detail::sighups.load(std::memory_order_relaxed)),
+    _snapshot(std::make_shared<const ArgsGroupT>(_defaults)) {}
 
-    if constexpr (sizeof...(OptionTs))
-        _unpack_opts(std::forward<OptionTs>(options)...);
+template <args_group ArgsGroupT>
+    requires std::copy_constructible<ArgsGroupT>
+auto reloader<ArgsGroupT>::reload() -> std::expected<size_t, error> {
+    std::lock_guard lock(_mutex);
+    return _reload();
 }
 
 template <args_group ArgsGroupT>
-ArgsGroupT greet(int argc, char *argv[]) {
-    ArgsGroupT args{};
-    meta m = args.genmeta();
-    _detail::print_helper printer(_detail::filename(argv[0]), m);
-
-    _detail::remove_one_arg(argc, argv);
-
-    while (argc) {
-        size_t argtype = _detail::argtype(argv[0]);
-
-        auto parse_helper = [&](const std::string &flag, bool newarg) -> bool {
-            auto result = m.query(flag);
-            if (!result) printer.unexpected_argument(flag);
-            auto &optref = result.value();
-
-            if (optref.get().need_argument()) {
-                if (!argc) printer.missing_value(flag, optref.get());
-                if (newarg) {
-                    if (argv[0][0] == '-' && !optref.get().allow_hyphen())
-                        printer.missing_value(flag, optref.get());
-                } else if (argv[0][0] == '=')
-                    argv[0] += 1;
-
-                if (optref.get().already_set())
-                    printer.used_mutiple(flag, optref.get());
-                std::errc ec = optref.get().set(argv[0]);
-                if (ec != std::errc{})
-                    printer.invalid_value(flag, argv[0], optref.get(), ec);
-                _detail::remove_one_arg(argc, argv);
-                return true;
-            } else {
-                if (argtype == _detail::LONG && !newarg && argv[0][0] == '=')
-                    printer.unexpected_value(flag, argv[0]);
-                if (optref.get().already_set())
-                    printer.used_mutiple(flag, optref.get());
-                optref.get().set();
-                return false;
-            }
-        };
+    requires std::copy_constructible<ArgsGroupT>
+auto reloader<ArgsGroupT>::poll() -> std::expected<bool, error> {
+    std::lock_guard lock(_mutex);
+    unsigned sighups = _detail::sighups.load(std::memory_order_relaxed);
+    if (sighups == _sighups) return false;
+    _sighups = sighups;
+    auto reloaded = _reload();
+    if (!reloaded) return std::unexpected(std::move(reloaded.error()));
+    return true;
+}
 
-        switch (argtype) {
-            case _detail::SHORT: {
-                ++argv[0];
-                while (true) {
-                    std::string flag = "-";
-                    flag += argv[0][0];
-                    ++argv[0];
-                    if (argv[0][0] == '\0') {
-                        _detail::remove_one_arg(argc, argv);
-                        parse_helper(flag, true);
-                        break;
-                    }
-                    if (parse_helper(flag, false)) break;
-                };
-            } break;
-            case _detail::LONG: {
-                char *split_pos = std::strchr(argv[0], '=');
-                if (split_pos) {
-                    std::string flag(argv[0], split_pos);
-                    argv[0] = split_pos;
-                    parse_helper(flag, false);
-                } else {
-                    std::string flag(argv[0]);
-                    _detail::remove_one_arg(argc, argv);
-                    parse_helper(flag, true);
-                }
-            } break;
-            case _detail::ARGUMENT:
-                printer.unexpected_argument(argv[0]);
-                break;
-            case _detail::ENDARG: {
-                _detail::remove_one_arg(argc, argv);
-                auto ignored_args = m.ignored_args();
-                if (ignored_args) ignored_args.value().get().reserve(argc);
-                while (argc) {
-                    if (ignored_args)
-                        ignored_args.value().get().emplace_back(argv[0]);
-                    _detail::remove_one_arg(argc, argv);
-                }
-            } break;
-            default:
-                std::unreachable();
-        }
+template <args_group ArgsGroupT>
+    requires std::copy_constructible<ArgsGroupT>
+std::shared_ptr<const ArgsGroupT> reloader<ArgsGroupT>::snapshot() const {
+    return _snapshot.load();
+}
 
-        if (m.help()) {
-            std::cout << args.description() << std::endl;
-            std::cout << std::endl;
-            printer.print_usage();
-            std::cout << std::endl;
-            printer.print_options();
-            std::exit(0);
-        }
-        if (m.version()) {
-            std::cout << args.version() << std::endl;
-            std::exit(0);
+template <args_group ArgsGroupT>
+    requires std::copy_constructible<ArgsGroupT>
+auto reloader<ArgsGroupT>::_reload() -> std::expected<size_t, error> {
+    auto next = std::make_shared<state>(
+        state{*_snapshot.load(), _detail::read_file(_path), {}, _values});
+    if (!_args.empty()) next->tokens.push_back(_args.front());
+    for (std::string_view token : tokenize(next->file))
+        next->tokens.push_back(token.data());
+    if (!_args.empty())
+        next->tokens.insert(
+            next->tokens.end(), _args.begin() + 1, _args.end());
+
+    // the values kept from the last snapshot start over, the others are
+    // copied from the default values before they are converted
+    std::ptrdiff_t offset = _detail::offset_between(_defaults, next->args);
+    if (auto ignored = _meta.ignored_args())
+        _detail::rebase(ignored->get(), offset) = ignored->get();
+    if (auto ignored = _meta.ignored_view_args())
+        _detail::rebase(ignored->get(), offset) = ignored->get();
+    if (auto *commands = _meta.commands()) commands->assign(offset, 0);
+
+    _detail::value_recorder recorder(_meta.opts().size());
+    auto parsed = _detail::parse(_meta, offset, next->tokens, recorder);
+    if (!parsed) return std::unexpected(std::move(parsed.error()));
+
+    size_t converted = 0;
+    for (size_t i = 0; i < _meta.opts().size(); ++i) {
+        if (std::ranges::equal(
+                recorder.values[i],
+                *_values[i],
+                {},
+                &_detail::value_recorder::value::text,
+                &_detail::value_recorder::value::text))
+            continue;
+
+        // converted from texts owned by the new snapshot, the kept values
+        // still view the ones it shares with the last snapshot
+        auto values =
+            std::make_shared<const std::vector<_detail::value_recorder::value>>(
+                std::move(recorder.values[i]));
+        next->values[i] = values;
+        const _detail::anyopt &optref = _meta.opts()[i];
+        optref.assign(offset, 0);
+        for (const auto &value : *values) {
+            std::errc ec =
+                value.setting ? _detail::set_setting(optref, offset, value.text)
+                              : optref.set(offset, value.text);
+            if (ec == std::errc{}) continue;
+            return std::unexpected(error{
+                .kind = _detail::value_error(ec),
+                .flag = value.flag,
+                .value = value.text,
+                .argname = std::string(_detail::get_argname(optref)),
+                .index = value.token,
+                .ec = ec,
+                .missing = {},
+                .commands = {},
+                .suggestions = {},
+                .location = {},
+            });
         }
+        ++converted;
     }
 
-    std::vector<std::reference_wrapper<_detail::anyopt>> missing_opts{};
-    for (const auto &optref : m.required_opts())
-        if (!optref.get().already_set()) missing_opts.emplace_back(optref);
-    if (missing_opts.size()) printer.missing_options(missing_opts);
-
-    return args;
-};
+    _values = next->values;
+    _snapshot.store(std::shared_ptr<const ArgsGroupT>(next, &next->args));
+    return converted;
+}
 
 }  // namespace greet
 
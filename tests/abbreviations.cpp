@@ -0,0 +1,79 @@
+// With `greet::abbreviations`, an unambiguous prefix of a long flag selects
+// it, and an exact flag wins over longer ones. Without it only exact flags
+// are accepted. Unknown long flags are reported with the closest flags.
+
+#include <iostream>
+
+#include "greet.hpp"
+
+struct Args : public greet::information {
+    bool verbose = false;
+    bool verify = false;
+    std::string name;
+    std::string names;
+
+    std::string version() override { return "abbreviations v1"; }
+    std::string description() override { return "abbreviations test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::abbreviations,
+            greet::opt(verbose).lng("verbose"),
+            greet::opt(verify).lng("verify"),
+            greet::opt(name).lng("name"),
+            greet::opt(names).lng("names"),
+        };
+    }
+};
+
+struct Exact : public greet::information {
+    bool verbose = false;
+    std::string name;
+
+    std::string version() override { return "exact v1"; }
+    std::string description() override { return "exact test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(verbose).lng("verbose"),
+            greet::opt(name).lng("name"),
+        };
+    }
+};
+
+template <typename ArgsGroupT>
+void run(const greet::parser<ArgsGroupT> &parser,
+         std::initializer_list<const char *> tokens) {
+    std::cout << "parse";
+    for (const char *token : tokens) std::cout << ' ' << token;
+    std::cout << '\n';
+    auto args = parser.try_parse(std::vector<const char *>(tokens));
+    if (!args) {
+        std::cout << args.error().message() << "\nsuggestions";
+        for (const std::string &flag : args.error().suggestions)
+            std::cout << ' ' << flag;
+        std::cout << "\n";
+    } else if constexpr (std::is_same_v<ArgsGroupT, Args>) {
+        std::cout << "verbose " << args->verbose << " verify " << args->verify
+                  << " name '" << args->name << "' names '" << args->names
+                  << "'\n";
+    } else {
+        std::cout << "verbose " << args->verbose << " name '" << args->name
+                  << "'\n";
+    }
+}
+
+int main() {
+    greet::parser<Args> parser;
+    run(parser, {"prog", "--verb", "--verif"});
+    run(parser, {"prog", "--ver"});
+    run(parser, {"prog", "--name", "a", "--names=b"});
+    run(parser, {"prog", "--nam", "a"});
+    run(parser, {"prog", "--n=a"});
+    run(parser, {"prog", "--verbosity"});
+    run(parser, {"prog", "--nmae", "a"});
+    run(parser, {"prog", "--xyz"});
+
+    greet::parser<Exact> exact;
+    run(exact, {"prog", "--verbose", "--name", "a"});
+    run(exact, {"prog", "--verb"});
+    run(exact, {"prog", "--nme", "a"});
+}
@@ -0,0 +1,70 @@
+// `greet::parse_batch()` parses one argument list per line and returns a
+// result for each line in order, failed lines do not stop the others. Large
+// buffers are parsed by several threads with the same results.
+
+#include <iostream>
+#include <string>
+
+#include "greet.hpp"
+
+struct Args : public greet::information {
+    std::string name;
+    int age = 0;
+    bool greeted = false;
+    std::vector<std::string> places;
+
+    std::string version() override { return "batch v1"; }
+    std::string description() override { return "batch test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(name).shrt('n').lng("name"),
+            greet::opt(age).lng("age").def(18),
+            greet::opt(greeted).shrt('g'),
+            greet::opt(places).shrt('p').lng("place"),
+        };
+    }
+};
+
+void print(const std::expected<Args, greet::error> &result) {
+    if (!result) {
+        std::cout << "error: " << result.error().message() << '\n';
+        return;
+    }
+    std::cout << "name '" << result->name << "' age " << result->age
+              << " greeted " << result->greeted << " places";
+    for (const std::string &place : result->places) std::cout << ' ' << place;
+    std::cout << '\n';
+}
+
+int main() {
+    auto results = greet::parse_batch<Args>(
+        "--name Kaeden\n"
+        "--name 'Kris Sally' -g --age 30\r\n"
+        "\n"
+        "--age many\n"
+        "-p \"new york\" -p chicago\n"
+        "--help\n"
+        "-n last");
+    for (const auto &result : results) print(result);
+
+    // large enough to be split between the threads, with a bad line now and
+    // then
+    std::string buffer;
+    for (int i = 0; i < 100000; ++i)
+        buffer += i % 1000 == 999 ? "--age x\n"
+                                  : "-n n" + std::to_string(i) + " --age " +
+                                        std::to_string(i % 100) + '\n';
+    for (size_t threads : {1, 4}) {
+        auto many = greet::parse_batch<Args>(buffer, threads);
+        size_t failed = 0, ordered = 0;
+        for (size_t i = 0; i < many.size(); ++i) {
+            if (!many[i])
+                ++failed;
+            else if (many[i]->name == "n" + std::to_string(i) &&
+                     many[i]->age == int(i % 100))
+                ++ordered;
+        }
+        std::cout << threads << " threads: " << many.size() << " results, "
+                  << ordered << " in order, " << failed << " failed\n";
+    }
+}
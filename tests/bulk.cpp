@@ -0,0 +1,64 @@
+// Values of a `deferred()` vector are converted at once after scanning, and
+// `delimiter()` splits a value into several elements in one pass. Either way
+// the errors are the same as converting each value while scanning.
+
+#include <iostream>
+
+#include "greet.hpp"
+
+struct Args : public greet::information {
+    std::vector<int> numbers;
+    std::vector<int> shards;
+    std::vector<std::string> names;
+    greet::inplace_vector<int, 4> ports;
+    int count = 0;
+
+    std::string version() override { return "bulk v1"; }
+    std::string description() override { return "bulk test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(numbers).shrt('x').lng("number").deferred(),
+            greet::opt(shards).lng("shard").delimiter(','),
+            greet::opt(names).lng("name").delimiter(':').deferred(),
+            greet::opt(ports).shrt('p').lng("port").delimiter(','),
+            greet::opt(count).shrt('c').lng("count"),
+        };
+    }
+};
+
+template <typename ContainerT>
+void print(const char *name, const ContainerT &values) {
+    std::cout << ' ' << name;
+    for (const auto &value : values) std::cout << " '" << value << "'";
+}
+
+void run(const greet::parser<Args> &parser,
+         std::initializer_list<const char *> tokens) {
+    auto args = parser.try_parse(std::vector<const char *>(tokens));
+    if (!args) {
+        std::cout << "error at " << args.error().index << ": "
+                  << args.error().message() << '\n';
+        return;
+    }
+    std::cout << "count " << args->count;
+    print("numbers", args->numbers);
+    print("shards", args->shards);
+    print("names", args->names);
+    print("ports", args->ports);
+    std::cout << '\n';
+}
+
+int main() {
+    greet::parser<Args> parser;
+    run(parser, {"prog", "-x", "1", "--number=2", "-x3", "-c", "7"});
+    run(parser, {"prog", "--shard", "1,2,3", "--shard=4", "--shard", ""});
+    run(parser, {"prog", "--name", "a:b::c", "--name", "d"});
+    run(parser, {"prog", "-p", "80,443", "-p", "8080,8443"});
+    run(parser, {"prog", "-p", "1,2,3", "-p", "4,5"});
+    run(parser, {"prog", "-p", "1,2,3,4,5"});
+    run(parser, {"prog", "--shard", "1,x,3"});
+    run(parser, {"prog", "--shard", "1,2,"});
+    run(parser, {"prog", "-x", "1", "-x", "two", "-x", "3", "-c", "four"});
+    run(parser, {"prog", "-c", "four", "-x", "one"});
+    run(parser, {"prog", "-x", "1", "-x", "2", "-c"});
+}
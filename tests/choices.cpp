@@ -0,0 +1,74 @@
+// An enumeration listed in `greet::choices` takes one of its names, both as a
+// NORMAL and as a VECTOR option, and the help lists the names.
+
+#include <iostream>
+
+#include "greet.hpp"
+
+enum class codec { h264, vp9, av1 };
+enum class level { low, high };
+
+template <>
+struct greet::choices<codec> {
+    static constexpr std::array values{
+        std::pair{"h264", codec::h264},
+        std::pair{"vp9", codec::vp9},
+        std::pair{"av1", codec::av1},
+    };
+};
+
+template <>
+struct greet::choices<level> {
+    static constexpr std::array values{
+        std::pair{"low", level::low},
+        std::pair{"high", level::high},
+    };
+};
+
+struct Args : public greet::information {
+    codec video = codec::h264;
+    std::vector<codec> fallbacks;
+    level quality = level::low;
+
+    std::string version() override { return "choices v1"; }
+    std::string description() override { return "choices test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(video).shrt('c').lng("codec").about("Video codec").def(
+                codec::vp9),
+            greet::opt(fallbacks).lng("fallback").about("Fallback codecs"),
+            greet::opt(quality).shrt('q').about("Quality"),
+        };
+    }
+};
+
+const char *names[] = {"h264", "vp9", "av1"};
+
+void run(const greet::parser<Args> &parser,
+         std::initializer_list<const char *> tokens) {
+    auto args = parser.try_parse(std::vector<const char *>(tokens));
+    if (!args) {
+        std::cout << "error: " << args.error().message() << '\n';
+        return;
+    }
+    std::cout << "codec " << names[int(args->video)] << " quality "
+              << (args->quality == level::high ? "high" : "low")
+              << " fallbacks";
+    for (codec fallback : args->fallbacks)
+        std::cout << ' ' << names[int(fallback)];
+    std::cout << '\n';
+}
+
+int main() {
+    greet::parser<Args> parser;
+    run(parser, {"prog"});
+    run(parser, {"prog", "-c", "av1", "-q", "high"});
+    run(parser, {"prog", "--codec=h264", "--fallback", "vp9", "--fallback",
+                 "av1"});
+    run(parser, {"prog", "-c", "mpeg"});
+    run(parser, {"prog", "-c", "AV1"});
+    run(parser, {"prog", "-c", "av"});
+    run(parser, {"prog", "--fallback", "av1x"});
+    run(parser, {"prog", "-q", ""});
+    std::cout << parser.printer().help("choices test", "prog");
+}
@@ -0,0 +1,78 @@
+// A cluster of short flags sets its switches one by one until a flag which
+// takes a value, the rest of the token or the next token is its value. Both
+// `greet::meta` and `greet::static_meta` parse clusters the same way.
+
+#include <iostream>
+
+#include "greet.hpp"
+
+struct Dynamic : public greet::information {
+    bool greeted = false;
+    greet::counter times;
+    std::string name;
+    std::vector<std::string> places;
+
+    std::string version() override { return "clusters v1"; }
+    std::string description() override { return "clusters test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(greeted).shrt('g'),
+            greet::opt(times).shrt('t'),
+            greet::opt(name).shrt('n'),
+            greet::opt(places).shrt('p'),
+        };
+    }
+};
+
+struct Static : public greet::static_information {
+    bool greeted = false;
+    greet::counter times;
+    std::string name;
+    std::vector<std::string> places;
+
+    std::string version() override { return "clusters v1"; }
+    std::string description() override { return "clusters test"; }
+    auto genmeta() {
+        return greet::static_meta{
+            greet::opt<'g'>(greeted),
+            greet::opt<'t'>(times),
+            greet::opt<'n'>(name),
+            greet::opt<'p'>(places),
+        };
+    }
+};
+
+template <typename ArgsGroupT>
+void run(const greet::parser<ArgsGroupT> &parser,
+         std::initializer_list<const char *> tokens) {
+    auto args = parser.try_parse(std::vector<const char *>(tokens));
+    if (!args) {
+        std::cout << "error: " << args.error().message() << '\n';
+        return;
+    }
+    greet::counter times = args->times;
+    std::cout << "greeted " << args->greeted << " times " << times
+              << " name '" << args->name << "' places";
+    for (const std::string &place : args->places) std::cout << ' ' << place;
+    std::cout << '\n';
+}
+
+template <typename ArgsGroupT>
+void run_all(const char *title) {
+    std::cout << title << '\n';
+    greet::parser<ArgsGroupT> parser;
+    run(parser, {"prog", "-gtttt"});
+    run(parser, {"prog", "-tgtnbob", "-tpx"});
+    run(parser, {"prog", "-ttn", "al", "-p", "y"});
+    run(parser, {"prog", "-ttn=al", "-gp=z"});
+    run(parser, {"prog", "-tnt"});
+    run(parser, {"prog", "-gg"});
+    run(parser, {"prog", "-tx"});
+    run(parser, {"prog", "-g=x"});
+    run(parser, {"prog", "-ttn"});
+}
+
+int main() {
+    run_all<Dynamic>("meta");
+    run_all<Static>("static_meta");
+}
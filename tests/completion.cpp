@@ -0,0 +1,94 @@
+// `__complete <words>...` prints the candidates of the last word and exits,
+// without calling `description()` of any argument group. The test runs
+// itself once per case, as `greet::greet()` exits after answering.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <sys/wait.h>
+
+#include "greet.hpp"
+
+struct Build : public greet::information {
+    bool release = false;
+    std::string target;
+
+    std::string version() override { return "build v1"; }
+    std::string description() override {
+        std::cout << "description() of build called\n";
+        return "Build the project";
+    }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(release).shrt('r').lng("release"),
+            greet::opt(target).shrt('t').lng("target"),
+        };
+    }
+};
+
+struct Run : public greet::information {
+    std::vector<std::string> arguments;
+
+    std::string version() override { return "run v1"; }
+    std::string description() override {
+        std::cout << "description() of run called\n";
+        return "Run the project";
+    }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(arguments).argname("ARGS"),
+        };
+    }
+};
+
+struct Rebuild : public Build {
+    std::string description() override {
+        std::cout << "description() of rebuild called\n";
+        return "Rebuild the project";
+    }
+};
+
+struct Args : public greet::information {
+    bool verbose = false;
+    std::string config;
+    greet::subcommands<Build, Run, Rebuild> command;
+
+    std::string version() override { return "completion v1"; }
+    std::string description() override {
+        std::cout << "description() of the program called\n";
+        return "completion test";
+    }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(verbose).shrt('v').lng("verbose"),
+            greet::opt(config).shrt('c').lng("config"),
+            greet::opt(command).names("build", "run", "rebuild").required(),
+        };
+    }
+};
+
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        greet::greet<Args>(argc, argv);
+        std::cout << "not answered\n";
+        return 0;
+    }
+    const char *cases[] = {
+        "__complete ''",
+        "__complete r",
+        "__complete --",
+        "__complete --ver",
+        "__complete -c r",
+        "__complete -v build --",
+        "__complete build -t x -",
+        "__complete run --",
+        "__completion nushell",
+    };
+    for (const char *words : cases) {
+        std::cout << "$ " << words << std::endl;
+        std::string command = std::string(argv[0]) + ' ' + words + " 2>&1";
+        std::cout << "exit " << WEXITSTATUS(std::system(command.c_str()))
+                  << std::endl;
+    }
+}
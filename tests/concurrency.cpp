@@ -0,0 +1,68 @@
+// A `const greet::parser` can be shared by threads parsing at the same time,
+// each parse keeps its state on its own stack and gets the same results as
+// parsing alone, including errors and the cached help message.
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "greet.hpp"
+
+struct Args : public greet::information {
+    std::string name;
+    int age = 0;
+    greet::counter times;
+    std::vector<std::string> places;
+
+    std::string version() override { return "concurrency v1"; }
+    std::string description() override { return "concurrency test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(name).shrt('n').lng("name").required(),
+            greet::opt(age).lng("age").def(18),
+            greet::opt(times).shrt('t'),
+            greet::opt(places).shrt('p').lng("place"),
+        };
+    }
+};
+
+int main() {
+    // the help of the shared parser is first rendered by the threads
+    greet::parser<Args> alone;
+    auto help = alone.printer().help("concurrency test", "prog");
+    const greet::parser<Args> parser;
+    std::atomic<size_t> good = 0, failed = 0, wrong = 0;
+    {
+        std::vector<std::jthread> threads;
+        for (int thread = 0; thread < 8; ++thread)
+            threads.emplace_back([&, thread] {
+                for (int i = 0; i < 2000; ++i) {
+                    std::string name = std::to_string(thread * 10000 + i);
+                    std::string age = std::to_string(i % 90);
+                    if (i % 100 == 0) age = "old";
+                    const char *tokens[] = {"prog", "-ttn", name.c_str(),
+                                            "--age", age.c_str(), "-p", "x"};
+                    auto args = parser.try_parse(tokens);
+                    if (!args) {
+                        bool expected = args.error().value == "old";
+                        ++(expected ? failed : wrong);
+                        continue;
+                    }
+                    greet::counter times = args->times;
+                    if (args->name == name && args->age == i % 90 &&
+                        times == 2 && args->places.size() == 1)
+                        ++good;
+                    else
+                        ++wrong;
+                    if (i % 500 == 0 &&
+                        parser.printer().help("concurrency test", "prog") !=
+                            help)
+                        ++wrong;
+                }
+            });
+    }
+    std::cout << good << " good, " << failed << " failed as expected, "
+              << wrong << " wrong\n";
+}
@@ -0,0 +1,69 @@
+// Options not given on the command line are taken from a config file, errors
+// in it name the file and the line they come from.
+
+#include <iostream>
+
+#include "greet.hpp"
+
+struct Args : public greet::information {
+    std::string name;
+    bool greeted = false;
+    greet::counter times;
+    std::vector<std::string> places;
+    int port = 0;
+    std::string_view host;
+
+    std::string version() override { return "config v1"; }
+    std::string description() override { return "config test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(name).shrt('n').lng("name"),
+            greet::opt(greeted).shrt('g').lng("greeted"),
+            greet::opt(times).shrt('t').lng("times"),
+            greet::opt(places).shrt('p').lng("place"),
+            greet::opt(port).lng("server.port").def(80),
+            greet::opt(host).lng("server.host"),
+        };
+    }
+};
+
+void run(const greet::parser<Args> &parser,
+         std::initializer_list<const char *> tokens,
+         const char *path = nullptr) {
+    std::vector<const char *> argv(tokens);
+    // `host` views the file
+    std::optional<greet::config_file> config;
+    if (path) config.emplace(path);
+    auto args = config ? parser.try_parse(argv, *config)
+                       : parser.try_parse(argv);
+    if (!args) {
+        std::cout << "error at " << args.error().index << ": "
+                  << args.error().message() << '\n';
+        return;
+    }
+    std::cout << "name '" << args->name << "' greeted " << args->greeted
+              << " times " << args->times << " port " << args->port
+              << " host '" << args->host << "' places";
+    for (const std::string &place : args->places)
+        std::cout << " '" << place << "'";
+    std::cout << '\n';
+}
+
+int main() {
+    greet::parser<Args> parser;
+    run(parser, {"prog"});
+    run(parser, {"prog"}, "data/layer.conf");
+    run(parser, {"prog", "-n", "al", "-t", "-p", "x"}, "data/layer.conf");
+    run(parser, {"prog"}, "data/missing.conf");
+    run(parser, {"prog"}, "data/repeated.conf");
+    run(parser, {"prog"}, "data/bad_value.conf");
+    run(parser, {"prog", "--server.port", "1"}, "data/bad_value.conf");
+    run(parser, {"prog"}, "data/bad_key.conf");
+    run(parser, {"prog"}, "data/bad_line.conf");
+
+    greet::config_file config("data/layer.conf");
+    std::cout << config.path() << " loaded " << config.loaded() << '\n';
+    for (const auto &entry : config.entries())
+        std::cout << entry.line << ' ' << entry.key << " = " << entry.value
+                  << '\n';
+}
@@ -0,0 +1,74 @@
+// Values reach the converters as views of exactly the value, whether it is a
+// whole token, the part after `=` or one element of a delimited value.
+// Converters only taking `const char *` get a null-terminated copy.
+
+#include <cstring>
+#include <iostream>
+
+#include "greet.hpp"
+
+// a converter written before views were passed, it reads up to the null
+struct word {
+    std::string text;
+};
+
+template <>
+struct greet::string_converter<word> {
+    static auto from_str(const char *str) -> std::expected<word, std::errc> {
+        if (!*str) return std::unexpected(std::errc::invalid_argument);
+        return word{std::string(str, std::strlen(str))};
+    }
+    static std::string to_str(const word &value) { return value.text; }
+};
+
+struct Args : public greet::information {
+    int number = 0;
+    unsigned char byte = 0;
+    double ratio = 0;
+    char letter = '?';
+    std::vector<word> words;
+    std::vector<int> numbers;
+
+    std::string version() override { return "converters v1"; }
+    std::string description() override { return "converters test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(number).lng("number"),
+            greet::opt(byte).lng("byte"),
+            greet::opt(ratio).lng("ratio"),
+            greet::opt(letter).lng("letter"),
+            greet::opt(words).shrt('w').lng("word").delimiter(','),
+            greet::opt(numbers).shrt('n').delimiter(','),
+        };
+    }
+};
+
+void run(const greet::parser<Args> &parser,
+         std::initializer_list<const char *> tokens) {
+    auto args = parser.try_parse(std::vector<const char *>(tokens));
+    if (!args) {
+        std::cout << "error: " << args.error().message() << '\n';
+        return;
+    }
+    std::cout << "number " << args->number << " byte " << int(args->byte)
+              << " ratio " << args->ratio << " letter " << args->letter
+              << " words";
+    for (const word &w : args->words) std::cout << " '" << w.text << "'";
+    std::cout << " numbers";
+    for (int n : args->numbers) std::cout << ' ' << n;
+    std::cout << '\n';
+}
+
+int main() {
+    greet::parser<Args> parser;
+    run(parser, {"prog", "--number", "0", "--byte=255", "--ratio=0.25"});
+    run(parser, {"prog", "--number=0x1f", "--byte", "017", "--letter=x"});
+    run(parser, {"prog", "--number=-12", "-n", "7,0x10,010"});
+    run(parser, {"prog", "-w", "alpha,beta", "--word=gamma", "-wdelta,e"});
+    run(parser, {"prog", "-w", "alpha,,beta"});
+    run(parser, {"prog", "--number", "12ab"});
+    run(parser, {"prog", "--byte", "256"});
+    run(parser, {"prog", "--ratio", "1.5x"});
+    run(parser, {"prog", "--letter", "xy"});
+    run(parser, {"prog", "-n", "1,2x,3"});
+}
@@ -0,0 +1,63 @@
+// `delimiter()` splits each value of a VECTOR option into several elements,
+// wherever the value comes from: a separate or attached token, an environment
+// variable or a config file. Options without it keep their values whole.
+
+#include <cstdlib>
+#include <iostream>
+
+#include "greet.hpp"
+
+struct Args : public greet::information {
+    std::vector<int> shards;
+    std::vector<std::string> roots;
+    std::vector<std::string> whole;
+
+    std::string version() override { return "delimiter v1"; }
+    std::string description() override { return "delimiter test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(shards).shrt('s').lng("shard").delimiter(','),
+            greet::opt(roots).shrt('r').lng("root").delimiter(':').env(
+                "DELIMITER_ROOTS"),
+            greet::opt(whole).shrt('w').lng("whole"),
+        };
+    }
+};
+
+void run(const greet::parser<Args> &parser,
+         std::initializer_list<const char *> tokens,
+         const greet::config_file *config = nullptr) {
+    std::vector<const char *> argv(tokens);
+    auto args =
+        config ? parser.try_parse(argv, *config) : parser.try_parse(argv);
+    if (!args) {
+        std::cout << "error: " << args.error().message() << '\n';
+        return;
+    }
+    std::cout << "shards";
+    for (int shard : args->shards) std::cout << ' ' << shard;
+    std::cout << " roots";
+    for (const std::string &root : args->roots)
+        std::cout << " '" << root << "'";
+    std::cout << " whole";
+    for (const std::string &value : args->whole)
+        std::cout << " '" << value << "'";
+    std::cout << '\n';
+}
+
+int main() {
+    greet::parser<Args> parser;
+    run(parser, {"prog", "-s", "1,2", "-s3,4", "--shard=5", "--shard", "6,7"});
+    run(parser, {"prog", "-r", "/a::/b:", "-w", "x,y:z"});
+    run(parser, {"prog", "-s", ",1"});
+    run(parser, {"prog", "-s", "1, 2"});
+
+    setenv("DELIMITER_ROOTS", "/env:/more", 1);
+    run(parser, {"prog"});
+    run(parser, {"prog", "-r", "/argv"});
+    unsetenv("DELIMITER_ROOTS");
+
+    greet::config_file config("data/delimiter.conf");
+    run(parser, {"prog"}, &config);
+    run(parser, {"prog", "-s", "9"}, &config);
+}
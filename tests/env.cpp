@@ -0,0 +1,71 @@
+// Options not given on the command line fall back to their environment
+// variables, which win over a config file.
+
+#include <cstdlib>
+#include <iostream>
+
+#include "greet.hpp"
+
+struct Args : public greet::information {
+    int threads = 1;
+    std::string name;
+    bool quiet = false;
+    greet::counter level;
+    std::vector<std::string> tags;
+
+    std::string version() override { return "env v1"; }
+    std::string description() override { return "env test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(threads).shrt('j').lng("threads").env("APP_THREADS"),
+            greet::opt(name).shrt('n').lng("name").env("APP_NAME"),
+            greet::opt(quiet).shrt('q').lng("quiet").env("APP_QUIET"),
+            greet::opt(level).shrt('l').lng("level").env("APP_LEVEL"),
+            greet::opt(tags).shrt('t').lng("tag").env("APP_TAGS"),
+        };
+    }
+};
+
+void run(const greet::parser<Args> &parser,
+         std::initializer_list<const char *> tokens,
+         const greet::config_file *config = nullptr) {
+    std::vector<const char *> argv(tokens);
+    auto args =
+        config ? parser.try_parse(argv, *config) : parser.try_parse(argv);
+    if (!args) {
+        std::cout << "error: " << args.error().message() << '\n';
+        return;
+    }
+    std::cout << "threads " << args->threads << " name '" << args->name
+              << "' quiet " << args->quiet << " level " << args->level
+              << " tags";
+    for (const std::string &tag : args->tags) std::cout << ' ' << tag;
+    std::cout << '\n';
+}
+
+int main() {
+    greet::parser<Args> parser;
+    greet::config_file config("data/env.conf");
+    run(parser, {"prog"});
+    run(parser, {"prog"}, &config);
+
+    setenv("APP_THREADS", "8", 1);
+    setenv("APP_QUIET", "true", 1);
+    setenv("APP_LEVEL", "3", 1);
+    setenv("APP_TAGS", "a b", 1);
+    setenv("APP_THREADSX", "99", 1);
+    run(parser, {"prog"});
+    run(parser, {"prog"}, &config);
+    run(parser, {"prog", "-j", "2", "-ll", "-t", "x", "-t", "y"}, &config);
+
+    setenv("APP_QUIET", "0", 1);
+    run(parser, {"prog"});
+    setenv("APP_QUIET", "maybe", 1);
+    run(parser, {"prog"});
+    run(parser, {"prog", "-q"});
+    unsetenv("APP_QUIET");
+    setenv("APP_THREADS", "many", 1);
+    run(parser, {"prog"});
+
+    std::cout << parser.printer().help("env test", "prog");
+}
@@ -0,0 +1,54 @@
+// `greet::inplace_vector` options take values until they are full, a value
+// which does not fit is an error, and a delimited value is stored whole or not
+// at all. Positional arguments fill them the same way.
+
+#include <iostream>
+
+#include "greet.hpp"
+
+struct Args : public greet::information {
+    greet::inplace_vector<std::string_view, 3> roots;
+    greet::inplace_vector<int, 4> shards;
+    greet::inplace_vector<std::string, 2> files;
+
+    std::string version() override { return "inplace_vector v1"; }
+    std::string description() override { return "inplace_vector test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(roots).shrt('I').about("Include roots"),
+            greet::opt(shards).lng("shard").delimiter(',').about("Shards"),
+            greet::opt(files).argname("FILES"),
+        };
+    }
+};
+
+void run(const greet::parser<Args> &parser,
+         std::initializer_list<const char *> tokens) {
+    auto args = parser.try_parse(std::vector<const char *>(tokens));
+    if (!args) {
+        std::cout << "error: " << args.error().message() << '\n';
+        return;
+    }
+    std::cout << "roots " << args->roots.size() << '/'
+              << args->roots.capacity() << (args->roots.full() ? " full" : "");
+    for (std::string_view root : args->roots) std::cout << ' ' << root;
+    std::cout << " shards";
+    for (int shard : args->shards) std::cout << ' ' << shard;
+    std::cout << " files";
+    for (size_t i = 0; i < args->files.size(); ++i)
+        std::cout << ' ' << args->files[i];
+    std::cout << '\n';
+}
+
+int main() {
+    greet::parser<Args> parser;
+    run(parser, {"prog"});
+    run(parser, {"prog", "-I", "a", "-Ib", "-I", "c", "x", "y"});
+    run(parser, {"prog", "-I", "a", "-I", "b", "-I", "c", "-I", "d"});
+    run(parser, {"prog", "--shard", "1,2", "--shard=3,4"});
+    run(parser, {"prog", "--shard", "1,2,3", "--shard", "4,5"});
+    run(parser, {"prog", "--shard", "1,2,3,4,5"});
+    run(parser, {"prog", "--shard", "1,x"});
+    run(parser, {"prog", "x", "y", "z"});
+    std::cout << parser.printer().help("inplace_vector test", "prog");
+}
@@ -0,0 +1,88 @@
+// A `greet::lazy` option keeps its token and converts it on first access, an
+// invalid value is only noticed there, unless it is validated while parsing.
+// Converted values are cached, and lazy values may be kept in vectors.
+
+#include <iostream>
+
+#include "greet.hpp"
+
+// a number of seconds such as `30s`, conversions are counted
+struct duration {
+    int seconds = 0;
+};
+
+int conversions = 0;
+
+template <>
+struct greet::string_converter<duration> {
+    static auto from_str(std::string_view str)
+        -> std::expected<duration, std::errc> {
+        ++conversions;
+        if (!str.ends_with('s'))
+            return std::unexpected(std::errc::invalid_argument);
+        str.remove_suffix(1);
+        auto seconds = greet::string_converter<int>::from_str(str);
+        if (!seconds) return std::unexpected(seconds.error());
+        return duration{*seconds};
+    }
+    static std::string to_str(const duration &value) {
+        return std::to_string(value.seconds) + 's';
+    }
+};
+
+struct Args : public greet::information {
+    greet::lazy<duration> timeout;
+    greet::lazy<duration, greet::lazy_mode::validated> interval;
+    std::vector<greet::lazy<duration>> delays;
+
+    std::string version() override { return "lazy v1"; }
+    std::string description() override { return "lazy test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(timeout).lng("timeout").def(duration{30}),
+            greet::opt(interval).lng("interval"),
+            greet::opt(delays).lng("delay"),
+        };
+    }
+};
+
+void print(const char *name, const greet::lazy<duration> &value) {
+    std::cout << "  " << name << " raw '" << value.raw() << "' ";
+    if (auto &converted = value.get())
+        std::cout << converted->seconds << "s\n";
+    else
+        std::cout << "invalid\n";
+}
+
+void run(const greet::parser<Args> &parser,
+         std::initializer_list<const char *> tokens) {
+    conversions = 0;
+    auto args = parser.try_parse(std::vector<const char *>(tokens));
+    std::cout << "parsed with " << conversions << " conversions\n";
+    if (!args) {
+        std::cout << "  error: " << args.error().message() << '\n';
+        return;
+    }
+    print("timeout", args->timeout);
+    print("timeout", args->timeout);
+    std::cout << "  interval " << args->interval->seconds << "s\n";
+    for (const auto &delay : args->delays) print("delay", delay);
+    std::cout << "  accessed with " << conversions << " conversions\n";
+}
+
+int main() {
+    greet::parser<Args> parser;
+    run(parser, {"prog"});
+    run(parser, {"prog", "--timeout", "5s", "--interval", "2s"});
+    run(parser, {"prog", "--timeout", "5", "--delay", "1s", "--delay", "x"});
+    run(parser, {"prog", "--interval", "2"});
+
+    Args args;
+    try {
+        args = parser.parse(std::vector<const char *>{"prog", "--timeout=x"});
+        std::cout << args.timeout->seconds << '\n';
+    } catch (const std::bad_expected_access<std::errc> &) {
+        std::cout << "invalid timeout throws on access\n";
+    }
+    std::cout << parser.printer().help("lazy test", "prog");
+}
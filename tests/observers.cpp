@@ -0,0 +1,76 @@
+// The observer of a `greet::parser` gets an event for each classified token,
+// flag lookup, value conversion, validation and parse, and `greet::parse_stats`
+// sums them up. Timings and allocations vary, so only their presence is shown.
+
+#include <iostream>
+
+#include "greet.hpp"
+
+struct Args : public greet::information {
+    std::string name;
+    int age = 0;
+    bool greeted = false;
+    std::vector<std::string> places;
+
+    std::string version() override { return "observers v1"; }
+    std::string description() override { return "observers test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(name).shrt('n').lng("name").required(),
+            greet::opt(age).lng("age").def(18),
+            greet::opt(greeted).shrt('g'),
+            greet::opt(places).argname("PLACES"),
+        };
+    }
+};
+
+const char *kinds[] = {"argument", "end of options", "short flags",
+                       "long flag"};
+
+struct printer : public greet::null_observer {
+    void on_token(std::string_view token, greet::token_kind kind) {
+        std::cout << "  token '" << token << "' " << kinds[int(kind)] << '\n';
+    }
+    void on_lookup(std::string_view flag, bool found) {
+        std::cout << "  lookup '" << flag << "' "
+                  << (found ? "found" : "missed") << '\n';
+    }
+    void on_conversion(std::string_view value, std::errc ec,
+                       std::chrono::nanoseconds) {
+        std::cout << "  conversion '" << value << "' "
+                  << (ec == std::errc{} ? "ok" : "failed") << '\n';
+    }
+    void on_validation(bool ok, std::chrono::nanoseconds) {
+        std::cout << "  validation " << (ok ? "ok" : "failed") << '\n';
+    }
+    void on_parse(bool ok, std::chrono::nanoseconds) {
+        std::cout << "  parse " << (ok ? "ok" : "failed") << '\n';
+    }
+};
+
+int main() {
+    greet::parser<Args, printer> events;
+    std::initializer_list<const char *> lists[] = {
+        {"prog", "-gn", "bob", "--age=30", "la", "--", "-x"},
+        {"prog", "--age", "old", "-n", "al"},
+        {"prog", "--nme", "al"},
+        {"prog", "-g"},
+    };
+    for (auto tokens : lists) {
+        std::cout << "parse";
+        for (const char *token : tokens) std::cout << ' ' << token;
+        std::cout << '\n';
+        (void)events.try_parse(std::vector<const char *>(tokens));
+    }
+
+    greet::parser<Args, greet::parse_stats> stats;
+    for (auto tokens : lists)
+        (void)stats.try_parse(std::vector<const char *>(tokens));
+    greet::parse_totals totals = stats.observer().totals();
+    std::cout << totals.parses << " parses, " << totals.failures
+              << " failures, " << totals.tokens << " tokens, "
+              << totals.lookups << " lookups, " << totals.misses
+              << " misses, " << totals.conversions << " conversions\n";
+    std::cout << "allocated " << (totals.allocations > 0) << " timed "
+              << (totals.parse.count() > 0) << '\n';
+}
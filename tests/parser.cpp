@@ -0,0 +1,46 @@
+// A `greet::parser` parses many argument lists with one schema, every result
+// starts from the default values.
+
+#include <iostream>
+
+#include "greet.hpp"
+
+struct Args : public greet::information {
+    std::string name;
+    size_t age = 0;
+    bool greeted = false;
+    greet::counter times;
+    std::vector<std::string> places;
+
+    std::string version() override { return "parser v1"; }
+    std::string description() override { return "parser test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(name).shrt('n').lng("name").required(),
+            greet::opt(age).lng("age").def(18u),
+            greet::opt(greeted).shrt('g'),
+            greet::opt(times).shrt('t'),
+            greet::opt(places).shrt('p').lng("place"),
+        };
+    }
+};
+
+void print(Args args) {
+    std::cout << args.name << ' ' << args.age << ' ' << args.greeted << ' '
+              << args.times << ' ' << args.places.size() << '\n';
+}
+
+int main() {
+    greet::parser<Args> parser;
+    const char *first[] = {"prog", "-n", "bob", "-ttt", "-p", "x", "-py"};
+    const char *second[] = {"prog", "--name=al", "--age", "7", "-g"};
+    for (int round = 0; round < 2; ++round) {
+        print(parser.parse(first));
+        print(parser.parse(second));
+    }
+
+    const char *missing[] = {"prog", "-g"};
+    std::cout << parser.try_parse(missing).error().message() << '\n';
+    const char *repeated[] = {"prog", "-n", "a", "-n", "b"};
+    std::cout << parser.try_parse(repeated).error().message() << '\n';
+}
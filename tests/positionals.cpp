@@ -0,0 +1,57 @@
+// Options without flags take the arguments which are not options in the order
+// they are declared, the last one may take all of the rest. A lone `-` is an
+// argument, both as a positional and as the value of a flag.
+
+#include <iostream>
+
+#include "greet.hpp"
+
+struct Args : public greet::information {
+    std::string mode;
+    int level = 0;
+    std::vector<std::string> files;
+    std::string output;
+    bool verbose = false;
+    greet::ignored others;
+
+    std::string version() override { return "positionals v1"; }
+    std::string description() override { return "positionals test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(mode).argname("MODE").required(),
+            greet::opt(level).argname("LEVEL").def(3),
+            greet::opt(files).argname("FILES"),
+            greet::opt(output).shrt('o').lng("output"),
+            greet::opt(verbose).shrt('v'),
+            greet::opt(others),
+        };
+    }
+};
+
+void run(const greet::parser<Args> &parser,
+         std::initializer_list<const char *> tokens) {
+    auto args = parser.try_parse(std::vector<const char *>(tokens));
+    if (!args) {
+        std::cout << "error: " << args.error().message() << '\n';
+        return;
+    }
+    std::cout << "mode '" << args->mode << "' level " << args->level
+              << " output '" << args->output << "' verbose " << args->verbose;
+    for (const std::string &file : args->files)
+        std::cout << " '" << file << "'";
+    std::cout << " others " << args->others.size() << '\n';
+}
+
+int main() {
+    greet::parser<Args> parser;
+    run(parser, {"prog", "build"});
+    run(parser, {"prog", "build", "5", "a", "-v", "b"});
+    run(parser, {"prog", "-o", "out", "test", "1", "--", "-x", "y"});
+    run(parser, {"prog", "cat", "2", "-"});
+    run(parser, {"prog", "-", "-o", "-"});
+    run(parser, {"prog", "-o", "-", "-v", "-"});
+    run(parser, {"prog", "build", "high"});
+    run(parser, {"prog", "-o", "-v"});
+    run(parser, {"prog"});
+    std::cout << parser.printer().usage("prog") << '\n';
+}
@@ -0,0 +1,120 @@
+// A `greet::reloader` parses the options file and the command line together,
+// and only converts the options whose values changed. Reloading the same
+// inputs again leaves every value as it was, including the ones from the
+// environment, and kept views stay valid after older snapshots are gone.
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "greet.hpp"
+
+struct Args : public greet::information {
+    std::string name;
+    greet::counter times;
+    greet::counter level;
+    std::vector<std::string> places;
+    std::vector<std::string> tags;
+    bool quiet = false;
+
+    std::string version() override { return "reload v1"; }
+    std::string description() override { return "reload test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(name).shrt('n').lng("name"),
+            greet::opt(times).shrt('t'),
+            greet::opt(level).lng("level").env("RELOAD_LEVEL"),
+            greet::opt(places).shrt('p').lng("place"),
+            greet::opt(tags).lng("tag").env("RELOAD_TAGS"),
+            greet::opt(quiet).lng("quiet").env("RELOAD_QUIET"),
+        };
+    }
+};
+
+struct Views : public greet::information {
+    std::string_view motd;
+    const char *user = nullptr;
+    int round = 0;
+
+    std::string version() override { return "views v1"; }
+    std::string description() override { return "reload views test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(motd).lng("motd"),
+            greet::opt(user).lng("user"),
+            greet::opt(round).lng("round"),
+        };
+    }
+};
+
+const char *path = "reload.conf";
+
+void write(const char *content) {
+    std::FILE *file = std::fopen(path, "wb");
+    std::fputs(content, file);
+    std::fclose(file);
+}
+
+void print(greet::reloader<Args> &reloader) {
+    auto converted = reloader.reload();
+    if (!converted) {
+        std::cout << "error: " << converted.error().message() << '\n';
+        return;
+    }
+    Args args = *reloader.snapshot();
+    std::cout << "converted " << *converted << ": name '" << args.name
+              << "' times " << args.times << " level " << args.level
+              << " quiet " << args.quiet << " places";
+    for (const std::string &place : args.places) std::cout << ' ' << place;
+    std::cout << " tags";
+    for (const std::string &tag : args.tags) std::cout << ' ' << tag;
+    std::cout << '\n';
+}
+
+int main() {
+    setenv("RELOAD_LEVEL", "2", 1);
+    setenv("RELOAD_TAGS", "env", 1);
+    setenv("RELOAD_QUIET", "true", 1);
+    const char *argv[] = {"prog", "-t", "-p", "argv"};
+    greet::reloader<Args> reloader(argv, path);
+
+    write("-n bob -tt -p file");
+    print(reloader);
+    print(reloader);
+    print(reloader);
+
+    write("-n al -p file -p more");
+    print(reloader);
+    print(reloader);
+
+    setenv("RELOAD_LEVEL", "3", 1);
+    unsetenv("RELOAD_QUIET");
+    print(reloader);
+    print(reloader);
+
+    write("--tag file --level");
+    print(reloader);
+    print(reloader);
+
+    setenv("RELOAD_LEVEL", "many", 1);
+    write("");
+    print(reloader);
+    print(reloader);
+
+    // the first snapshot converted `motd` and `user`, later ones keep them
+    const char *program[] = {"prog"};
+    greet::reloader<Views> views(program, path);
+    const char *contents[] = {
+        "--motd hello --user bob --round 1",
+        "--motd hello --user bob --round 2",
+        "--round 3 --user bob --motd hello",
+    };
+    for (const char *content : contents) {
+        write(content);
+        std::cout << "converted " << *views.reload();
+        auto snapshot = views.snapshot();
+        std::cout << ": motd '" << snapshot->motd << "' user '"
+                  << snapshot->user << "' round " << snapshot->round << '\n';
+    }
+    std::remove(path);
+}
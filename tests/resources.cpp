@@ -0,0 +1,86 @@
+// The schema, the parsing and the help message of greet allocate from the
+// given memory resource, and a `greet::arena` only falls back to its upstream
+// resource once its buffer is used up. Allocation counts depend on the
+// standard library, so only whether they happened is shown.
+
+#include <iostream>
+#include <memory_resource>
+
+#include "greet.hpp"
+
+// counts the allocations passed on to the default resource
+struct counting_resource : public std::pmr::memory_resource {
+    size_t allocations = 0;
+    size_t outstanding = 0;
+
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        outstanding += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+        outstanding -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const
+        noexcept override {
+        return this == &other;
+    }
+};
+
+struct Args : public greet::information {
+    std::string name;
+    int age = 0;
+    std::vector<std::string> places;
+
+    std::string version() override { return "resources v1"; }
+    std::string description() override { return "resources test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(name).shrt('n').lng("name").about("Name to greet"),
+            greet::opt(age).lng("age").def(18).about("Age to greet"),
+            greet::opt(places).shrt('p').lng("place").about("Places"),
+        };
+    }
+};
+
+char prog[] = "prog", name[] = "-n", bob[] = "bob", place[] = "--place=x";
+char *argv[] = {prog, name, bob, place};
+
+int main() {
+    counting_resource counting;
+    {
+        auto args = greet::try_greet<Args>(4, argv, &counting);
+        std::cout << "try_greet '" << args->name << "' " << args->places[0]
+                  << " allocated " << (counting.allocations > 0)
+                  << " outstanding " << (counting.outstanding > 0) << '\n';
+    }
+
+    counting.allocations = 0;
+    {
+        greet::parser<Args> parser(&counting);
+        std::cout << "schema allocated " << (counting.allocations > 0) << '\n';
+        Args args = parser.parse(std::span<const char *const>(argv, 4));
+        std::cout << "parse '" << args.name << "'\n";
+        size_t parsed = counting.allocations;
+        std::cout << parser.printer().help("resources test", "prog");
+        std::cout << "help allocated " << (counting.allocations > parsed)
+                  << '\n';
+    }
+    std::cout << "parser released " << (counting.outstanding == 0) << '\n';
+
+    counting.allocations = 0;
+    {
+        greet::arena<65536> session(&counting);
+        auto args = greet::try_greet<Args>(4, argv, &session);
+        std::cout << "large arena '" << args->name << "' upstream "
+                  << (counting.allocations > 0) << '\n';
+    }
+    {
+        greet::arena<64> session(&counting);
+        auto args = greet::try_greet<Args>(4, argv, &session);
+        std::cout << "small arena '" << args->name << "' upstream "
+                  << (counting.allocations > 0) << '\n';
+    }
+    std::cout << "arenas released " << (counting.outstanding == 0) << '\n';
+}
@@ -0,0 +1,74 @@
+// `@path` tokens are only expanded when the parse is given a
+// `greet::response_files`, which owns the files and the spliced tokens.
+
+#include <fstream>
+#include <iostream>
+
+#include "greet.hpp"
+
+struct Args : public greet::information {
+    std::string_view name;
+    std::vector<std::string> places;
+    greet::counter times;
+    greet::ignored_view rest;
+
+    std::string version() override { return "response_files v1"; }
+    std::string description() override { return "response_files test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(name).shrt('n'),
+            greet::opt(places).shrt('p').lng("place"),
+            greet::opt(times).shrt('t'),
+            greet::opt(rest),
+        };
+    }
+};
+
+void print(const std::expected<Args, greet::error> &args) {
+    if (!args) {
+        std::cout << "error: " << args.error().message() << '\n';
+        return;
+    }
+    std::cout << "name '" << args->name << "' times " << Args(*args).times;
+    for (const auto &place : args->places)
+        std::cout << " place '" << place << "'";
+    for (const char *arg : args->rest) std::cout << " rest '" << arg << "'";
+    std::cout << '\n';
+}
+
+// how many mappings of the process come from files named `name`
+size_t mappings(std::string_view name) {
+    std::ifstream maps("/proc/self/maps");
+    size_t count = 0;
+    for (std::string line; std::getline(maps, line);)
+        count += line.ends_with(name);
+    return count;
+}
+
+int main() {
+    greet::parser<Args> parser;
+    const char *expanded[] = {
+        "prog", "@data/args.rsp", "-p", "@@literal", "-p@@glued"};
+    const char *looped[] = {"prog", "@data/loop.rsp"};
+    const char *tail[] = {"prog", "@data/tail.rsp", "z"};
+    const char *missing[] = {"prog", "-p", "@data/missing.rsp"};
+
+    // without an owner nothing is expanded
+    const char *plain[] = {"prog", "-p", "@data/args.rsp", "-p@@x"};
+    print(parser.try_parse(plain));
+
+    greet::response_files files;
+    std::cout << "mapped before " << mappings("args.rsp") << '\n';
+    print(parser.try_parse(expanded, files));
+    print(parser.try_parse(looped, files));
+    print(parser.try_parse(tail, files));
+    print(parser.try_parse(missing, files));
+
+    std::vector<char *> argv{const_cast<char *>("prog"),
+                             const_cast<char *>("@data/more.rsp")};
+    print(greet::try_greet<Args>(argv.size(), argv.data()));
+    print(greet::try_greet<Args>(argv.size(), argv.data(), files));
+    std::cout << "mapped while owned " << mappings("args.rsp") << '\n';
+    files = greet::response_files();
+    std::cout << "mapped after release " << mappings("args.rsp") << '\n';
+}
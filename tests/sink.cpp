@@ -0,0 +1,53 @@
+// `greet::opt_sink()` takes the remaining positional arguments and hands each
+// value to its callback as soon as it is parsed, the callback may reject a
+// value. A `greet::parser` calls the same callback for every parse.
+
+#include <iostream>
+
+#include "greet.hpp"
+
+std::vector<std::string> received;
+
+struct Args : public greet::information {
+    std::string mode;
+    bool verbose = false;
+
+    std::string version() override { return "sink v1"; }
+    std::string description() override { return "sink test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(mode).argname("MODE").required(),
+            greet::opt(verbose).shrt('v'),
+            greet::opt_sink([](std::string_view path) -> std::errc {
+                if (path == "bad") return std::errc::invalid_argument;
+                received.emplace_back(path);
+                return {};
+            })
+                .argname("PATH")
+                .about("Files to process"),
+        };
+    }
+};
+
+void run(const greet::parser<Args> &parser,
+         std::initializer_list<const char *> tokens) {
+    received.clear();
+    auto args = parser.try_parse(std::vector<const char *>(tokens));
+    if (!args)
+        std::cout << "error: " << args.error().message() << '\n';
+    else
+        std::cout << "mode '" << args->mode << "' verbose " << args->verbose
+                  << '\n';
+    std::cout << "  received";
+    for (const std::string &path : received) std::cout << ' ' << path;
+    std::cout << '\n';
+}
+
+int main() {
+    greet::parser<Args> parser;
+    run(parser, {"prog", "copy"});
+    run(parser, {"prog", "copy", "a", "-v", "b", "-", "--", "-c"});
+    run(parser, {"prog", "copy", "a", "bad", "b"});
+    run(parser, {"prog", "copy", "a", "-x"});
+    std::cout << parser.printer().help("sink test", "prog");
+}
@@ -0,0 +1,136 @@
+// `greet::save()` stores parsed values in a binary snapshot which
+// `greet::load()` reads back without parsing, snapshots that are malformed or
+// from another schema are refused.
+
+#include <cstdint>
+#include <iostream>
+
+#include "greet.hpp"
+
+struct Args : public greet::information {
+    std::string name;
+    int age = 0;
+    bool greeted = false;
+    greet::counter times;
+    std::vector<std::string> places;
+    std::string_view note;
+
+    std::string version() override { return "snapshots v1"; }
+    std::string description() override { return "snapshots test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(name).shrt('n').lng("name"),
+            greet::opt(age).lng("age").def(18),
+            greet::opt(greeted).shrt('g'),
+            greet::opt(times).shrt('t'),
+            greet::opt(places).shrt('p').lng("place"),
+            greet::opt(note).lng("note"),
+        };
+    }
+};
+
+struct Other : public greet::information {
+    std::string name;
+    long age = 0;
+
+    std::string version() override { return "other v1"; }
+    std::string description() override { return "other schema"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(name).shrt('n').lng("name"),
+            greet::opt(age).lng("age"),
+        };
+    }
+};
+
+enum class codec { h264, vp9 };
+
+template <>
+struct greet::choices<codec> {
+    static constexpr std::array values{
+        std::pair{"h264", codec::h264},
+        std::pair{"vp9", codec::vp9},
+    };
+};
+
+struct Raw : public greet::information {
+    std::vector<codec> fallbacks;
+    codec video = codec::h264;
+    bool greeted = false;
+
+    std::string version() override { return "raw v1"; }
+    std::string description() override { return "raw values only"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(fallbacks).lng("fallback"),
+            greet::opt(video).lng("codec"),
+            greet::opt(greeted).shrt('g'),
+        };
+    }
+};
+
+struct Counted : public greet::information {
+    greet::counter times;
+
+    std::string version() override { return "counted v1"; }
+    std::string description() override { return "a counter only"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(times).shrt('t'),
+        };
+    }
+};
+
+void print(std::optional<Args> args) {
+    if (!args) {
+        std::cout << "refused\n";
+        return;
+    }
+    std::cout << "name '" << args->name << "' age " << args->age
+              << " greeted " << args->greeted << " times " << args->times
+              << " note '" << args->note << "' places";
+    for (const std::string &place : args->places) std::cout << ' ' << place;
+    std::cout << '\n';
+}
+
+int main() {
+    greet::parser<Args> parser;
+    const char *tokens[] = {"prog", "-n",     "bob", "-gttt", "-p",
+                            "x",    "--place", "y",  "--note", "hello"};
+    std::string snapshot = greet::save(parser.parse(tokens));
+    print(greet::load<Args>(snapshot));
+    print(greet::load<Args>(greet::save(Args{})));
+
+    std::cout << "other schema ";
+    std::cout << (greet::load<Other>(snapshot) ? "loaded\n" : "refused\n");
+    std::cout << "truncated ";
+    print(greet::load<Args>(snapshot.substr(0, snapshot.size() - 1)));
+    std::cout << "trailing ";
+    print(greet::load<Args>(snapshot + '\0'));
+    std::cout << "no magic ";
+    print(greet::load<Args>(snapshot.substr(1)));
+
+    // raw values are checked, a bool is 0 or 1 and a choice is listed
+    Raw raw;
+    raw.fallbacks = {codec::vp9};
+    std::string valid = greet::save(raw);
+    auto check = [&](const char *what, size_t from_end, size_t size) {
+        std::string bad = valid;
+        bad.replace(bad.size() - from_end, size, size, '\2');
+        std::cout << what
+                  << (greet::load<Raw>(bad) ? " loaded\n" : " refused\n");
+    };
+    std::cout << "raw " << (greet::load<Raw>(valid) ? "loaded\n" : "refused\n");
+    check("bool 2", 1, 1);
+    check("codec not listed", 1 + sizeof(codec), sizeof(codec));
+    check("fallback not listed", 1 + 2 * sizeof(codec), sizeof(codec));
+
+    // the count is taken as it is, not counted up to
+    Counted counted;
+    std::string hostile = greet::save(counted);
+    hostile.replace(hostile.size() - 8, 8, 8, '\xff');
+    auto loaded = greet::load<Counted>(hostile);
+    std::cout << "hostile count "
+              << (loaded && size_t(loaded->times) == SIZE_MAX ? "max" : "?")
+              << '\n';
+}
@@ -0,0 +1,50 @@
+// A `greet::static_meta` dispatches to its options through tables generated
+// at compile time, it parses and describes options like `greet::meta`.
+
+#include <iostream>
+
+#include "greet.hpp"
+
+struct Args : public greet::static_information {
+    std::string name;
+    size_t age = 0;
+    bool greeted = false;
+    greet::counter times;
+    std::vector<std::string> places;
+    greet::ignored others;
+
+    std::string version() override { return "static_meta v1"; }
+    std::string description() override { return "static_meta test"; }
+    auto genmeta() {
+        return greet::static_meta{
+            greet::opt<'n', "name">(name).required().about("Name to greet"),
+            greet::opt<"age">(age).def(18u).about("Age to greet"),
+            greet::opt<'g'>(greeted).about("Have greeted"),
+            greet::opt<'t'>(times).about("Times to greet"),
+            greet::opt<'p', "place">(places).argname("WHERE").about("Places"),
+            greet::opt(others),
+        };
+    }
+};
+
+void run(const greet::parser<Args> &parser,
+         std::initializer_list<const char *> tokens) {
+    auto args = parser.try_parse(std::vector<const char *>(tokens));
+    if (!args) {
+        std::cout << "error: " << args.error().message() << '\n';
+        return;
+    }
+    std::cout << args->name << ' ' << args->age << ' ' << args->greeted << ' '
+              << args->times << ' ' << args->places.size() << ' '
+              << args->others.size() << '\n';
+}
+
+int main() {
+    greet::parser<Args> parser;
+    run(parser, {"prog", "-n", "bob", "-gtt", "--place=x", "-py", "--", "z"});
+    run(parser, {"prog", "--name", "al", "--age", "7"});
+    run(parser, {"prog", "-gg"});
+    run(parser, {"prog", "-n", "bob", "--age", "old"});
+    run(parser, {"prog", "-t"});
+    std::cout << parser.printer().help("static_meta test", "prog");
+}
@@ -0,0 +1,39 @@
+// `std::string_view` and `const char *` options view the arguments, and
+// `greet::ignored_view` keeps the arguments after `--` without copying.
+
+#include <iostream>
+
+#include "greet.hpp"
+
+struct Args : public greet::information {
+    std::string_view name;
+    const char *place = "";
+    std::vector<std::string_view> tags;
+    greet::ignored_view rest;
+
+    std::string version() override { return "string_view v1"; }
+    std::string description() override { return "string_view test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(name).shrt('n'),
+            greet::opt(place).shrt('p'),
+            greet::opt(tags).shrt('t'),
+            greet::opt(rest),
+        };
+    }
+};
+
+int main() {
+    char name[] = "bob";
+    char place[] = "--place=home";
+    const char *argv[] = {"prog", "-n", name, "-p", place + 8, "-ta",
+                          "-tb", "--", "x", "-y"};
+    auto args =
+        greet::try_greet<Args>(std::size(argv), const_cast<char **>(argv));
+    std::cout << args->name << ' ' << args->place << '\n';
+    std::cout << "name views argv: " << (args->name.data() == name) << '\n';
+    std::cout << "place views argv: " << (args->place == place + 8) << '\n';
+    for (auto tag : args->tags) std::cout << "tag " << tag << '\n';
+    for (const char *arg : args->rest) std::cout << "rest " << arg << '\n';
+    std::cout << "rest views argv: " << (args->rest.data() == argv + 8) << '\n';
+}
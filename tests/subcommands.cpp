@@ -0,0 +1,104 @@
+// The first argument which is not an option selects a subcommand, the
+// arguments after it are parsed with its options, and only the `genmeta()`
+// of the selected subcommand is called. Errors name the subcommands they come
+// from, and help of a subcommand is printed with its own usage.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <sys/wait.h>
+
+#include "greet.hpp"
+
+// the runs answering help and errors don't trace `genmeta()`
+bool traced = true;
+
+struct Build : public greet::information {
+    bool release = false;
+    std::string target;
+
+    std::string version() override { return "build v1"; }
+    std::string description() override { return "Build the project"; }
+    greet::meta genmeta() override {
+        if (traced) std::cout << "  genmeta() of build\n";
+        return {
+            greet::opt(release).shrt('r').lng("release").about("Optimize"),
+            greet::opt(target).shrt('t').lng("target").about("Target"),
+        };
+    }
+};
+
+struct Run : public greet::information {
+    std::string program;
+    std::vector<std::string> arguments;
+
+    std::string version() override { return "run v1"; }
+    std::string description() override { return "Run the project"; }
+    greet::meta genmeta() override {
+        if (traced) std::cout << "  genmeta() of run\n";
+        return {
+            greet::opt(program).argname("PROGRAM").required(),
+            greet::opt(arguments).argname("ARGS"),
+        };
+    }
+};
+
+struct Args : public greet::information {
+    bool verbose = false;
+    greet::subcommands<Build, Run> command;
+
+    std::string version() override { return "subcommands v1"; }
+    std::string description() override { return "subcommands test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(verbose).shrt('v').lng("verbose").about("Be verbose"),
+            greet::opt(command).names("build", "run").required(),
+        };
+    }
+};
+
+void run(std::initializer_list<const char *> tokens) {
+    std::cout << "parse";
+    for (const char *token : tokens) std::cout << ' ' << token;
+    std::cout << '\n';
+    auto args = greet::try_greet<Args>(std::vector<std::string_view>(
+        tokens.begin(), tokens.end()));
+    if (!args) {
+        std::cout << "  error: " << args.error().message();
+        for (const std::string &command : args.error().commands)
+            std::cout << " [" << command << ']';
+        std::cout << '\n';
+    } else if (auto *build = std::get_if<Build>(&args->command)) {
+        std::cout << "  verbose " << args->verbose << " build release "
+                  << build->release << " target '" << build->target << "'\n";
+    } else if (auto *run = std::get_if<Run>(&args->command)) {
+        std::cout << "  verbose " << args->verbose << " run '" << run->program
+                  << "'";
+        for (const std::string &argument : run->arguments)
+            std::cout << ' ' << argument;
+        std::cout << '\n';
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        traced = false;
+        greet::greet<Args>(argc, argv);
+        return 0;
+    }
+    run({"prog", "-v", "build", "--release", "-t", "x86"});
+    run({"prog", "run", "app", "a", "--", "-v"});
+    run({"prog", "run", "app", "-v"});
+    run({"prog", "build", "-v"});
+    run({"prog", "run"});
+    run({"prog", "test"});
+    run({"prog", "-v"});
+
+    for (const char *words : {"--help", "build --help", "run"}) {
+        std::cout << "$ " << words << std::endl;
+        std::string command = std::string(argv[0]) + ' ' + words + " 2>&1";
+        std::cout << "exit " << WEXITSTATUS(std::system(command.c_str()))
+                  << std::endl;
+    }
+}
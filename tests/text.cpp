@@ -0,0 +1,47 @@
+// Flag names and help texts keep a `std::string_view` as a view, any other
+// string, such as a literal, a character array or a `std::string`, is copied,
+// so it may change or go away after the schema is built.
+
+#include <cstring>
+#include <iostream>
+
+#include "greet.hpp"
+
+char name_about[] = "Name to greet";
+char place_about[] = "Where to greet";
+std::string greeted_long = "greeted";
+
+struct Args : public greet::information {
+    std::string name;
+    std::vector<std::string> places;
+    bool greeted = false;
+    int level = 0;
+    int depth = 0;
+
+    std::string version() override { return "text v1"; }
+    std::string description() override { return "text test"; }
+    greet::meta genmeta() override {
+        // neither is a constant expression, they still compile and are copied
+        const char level_long[8] = "level";
+        static const char depth_about[] = "How deep to greet";
+        return {
+            greet::opt(name).shrt('n').lng("name").about(name_about),
+            greet::opt(places).shrt('p').lng("place").about(place_about),
+            greet::opt(greeted).shrt('g').lng(greeted_long).about(
+                std::string("Have greeted")),
+            greet::opt(level).lng(level_long).about(std::string_view("Level")),
+            greet::opt(depth).lng("depth").about(depth_about),
+        };
+    }
+};
+
+int main() {
+    greet::parser<Args> parser;
+    std::strcpy(name_about, "overwritten!");
+    std::strcpy(place_about, "overwritten!!!");
+    greeted_long = "changed";
+    const char *tokens[] = {"prog", "--name", "bob", "--greeted"};
+    Args args = parser.parse(tokens);
+    std::cout << args.name << ' ' << args.greeted << '\n';
+    std::cout << parser.printer().help("text test", "prog");
+}
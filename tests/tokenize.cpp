@@ -0,0 +1,72 @@
+// `greet::tokenize()` splits a command string like response files, and
+// `greet::greet()` and `greet::try_greet()` parse any range of tokens, the
+// first one being the program name.
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "greet.hpp"
+
+struct Args : public greet::information {
+    std::string name;
+    bool greeted = false;
+    const char *place = nullptr;
+    greet::ignored_view others;
+
+    std::string version() override { return "tokenize v1"; }
+    std::string description() override { return "tokenize test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(name).shrt('n').lng("name"),
+            greet::opt(greeted).shrt('g'),
+            greet::opt(place).shrt('p'),
+            greet::opt(others),
+        };
+    }
+};
+
+void split(std::string_view command) {
+    std::string buffer;
+    size_t count = 0;
+    for (std::string_view token : greet::tokenize(command, buffer)) {
+        std::cout << '<' << token << "> ";
+        ++count;
+    }
+    std::cout << count << " tokens\n";
+}
+
+void print(const std::expected<Args, greet::error> &args) {
+    if (!args) {
+        std::cout << "error: " << args.error().message() << '\n';
+        return;
+    }
+    std::cout << "name '" << args->name << "' greeted " << args->greeted
+              << " place '" << (args->place ? args->place : "") << "' others";
+    for (std::string_view other : args->others)
+        std::cout << " <" << other << '>';
+    std::cout << '\n';
+}
+
+int main() {
+    split("");
+    split("  a\tb \n c  ");
+    split("'single quoted' \"double \\\" quoted\" mixed'qu'\"ot\"ed");
+    split("back\\ slash \\'x\\' \"\\a\\\\\"");
+    split("'' \"\" x''");
+    split("'unclosed quote");
+
+    std::string command = "prog -n 'Kris Sally' -g -p \"new york\" -- a 'b c'";
+    print(greet::try_greet<Args>(greet::tokenize(command)));
+
+    std::string buffer;
+    Args args =
+        greet::greet<Args>(greet::tokenize("prog --name=Kaeden -p la", buffer));
+    std::cout << args.name << ' ' << args.place << '\n';
+
+    std::vector<std::string_view> tokens{"prog", "-gn", "vec"};
+    print(greet::try_greet<Args>(tokens));
+    std::vector<std::string> strings{"prog", "--name", "strings", "--bad"};
+    print(greet::try_greet<Args>(strings));
+}
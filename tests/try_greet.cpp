@@ -0,0 +1,48 @@
+// `greet::try_greet()` returns the error instead of printing it and exiting,
+// `-h` and `-V` are errors too.
+
+#include <iostream>
+
+#include "greet.hpp"
+
+struct Args : public greet::information {
+    std::string name;
+    int count = 1;
+    bool verbose = false;
+
+    std::string version() override { return "try_greet v1"; }
+    std::string description() override { return "try_greet test"; }
+    greet::meta genmeta() override {
+        return {
+            greet::opt(name).shrt('n').lng("name").required(),
+            greet::opt(count).shrt('c').lng("count").def(1),
+            greet::opt(verbose).shrt('v'),
+        };
+    }
+};
+
+void run(std::initializer_list<const char *> tokens) {
+    std::vector<char *> argv;
+    for (const char *token : tokens) argv.push_back(const_cast<char *>(token));
+    auto args = greet::try_greet<Args>(argv.size(), argv.data());
+    if (args) {
+        std::cout << "ok " << args->name << ' ' << args->count << ' '
+                  << args->verbose << '\n';
+        return;
+    }
+    const greet::error &err = args.error();
+    std::cout << "error " << static_cast<int>(err.kind) << " at " << err.index
+              << ": " << err.message() << '\n';
+}
+
+int main() {
+    run({"prog", "-n", "bob", "-c", "3", "-v"});
+    run({"prog", "--name", "al"});
+    run({"prog", "-n"});
+    run({"prog", "-n", "bob", "-c", "x"});
+    run({"prog", "-n", "bob", "-v=1"});
+    run({"prog", "-n", "bob", "--verbose"});
+    run({"prog", "-n", "bob", "extra"});
+    run({"prog", "-h"});
+    run({"prog", "-V"});
+}